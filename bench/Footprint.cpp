@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "Policies.h"
+
+// Heap bytes each policy spends per resident entry, measured by replacing global operator new/delete.
+// Every policy is filled to steady state (4x its capacity in distinct keys, each Put twice so LRU-K admits
+// them too, then as many Gets on absent keys), and the live heap it holds is divided by the number of distinct
+// keys a Get still finds. Ghost lists, history and indices therefore count against the resident entries
+// they exist for. Allocator bookkeeping is not included.
+// Usage: CacheFootprint [capacity]
+
+namespace {
+
+	std::atomic<size_t> g_liveBytes{ 0 };
+
+	// the block's size and header length sit just in front of the pointer handed out
+	void* _Allocate(size_t size, size_t alignment)
+	{
+		size_t header = std::max(alignof(std::max_align_t), alignment);
+		void* raw = alignment > alignof(std::max_align_t)
+			? std::aligned_alloc(alignment, (header + size + alignment - 1) / alignment * alignment)
+			: std::malloc(header + size);
+		if (!raw)
+			throw std::bad_alloc();
+
+		size_t* user = reinterpret_cast<size_t*>(static_cast<char*>(raw) + header);
+		user[-1] = size;
+		user[-2] = header;
+		g_liveBytes.fetch_add(size, std::memory_order_relaxed);
+		return user;
+	}
+
+	void _Free(void* ptr)
+	{
+		if (!ptr)
+			return;
+		size_t* user = static_cast<size_t*>(ptr);
+		g_liveBytes.fetch_sub(user[-1], std::memory_order_relaxed);
+		std::free(reinterpret_cast<char*>(user) - user[-2]);
+	}
+}
+
+void* operator new(size_t size) { return _Allocate(size, 0); }
+void* operator new[](size_t size) { return _Allocate(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return _Allocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return _Allocate(size, static_cast<size_t>(alignment)); }
+void operator delete(void* ptr) noexcept { _Free(ptr); }
+void operator delete[](void* ptr) noexcept { _Free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { _Free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { _Free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { _Free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { _Free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { _Free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { _Free(ptr); }
+
+namespace Bench {
+
+	struct Record32
+	{
+		int64_t fields[4];
+	};
+
+	template<typename T> T MakeValue(int index);
+	template<> int MakeValue<int>(int index) { return index; }
+	template<> Record32 MakeValue<Record32>(int index) { return Record32{ { index, index, index, index } }; }
+	template<> std::string MakeValue<std::string>(int index) { return std::string(64, static_cast<char>('a' + index % 26)); }
+
+	template<typename T> const char* TypeName();
+	template<> const char* TypeName<int>() { return "int"; }
+	template<> const char* TypeName<Record32>() { return "Record32"; }
+	template<> const char* TypeName<std::string>() { return "string(64)"; }
+
+	// what an entry has to store at minimum
+	template<typename T> size_t PayloadBytes() { return sizeof(T); }
+	template<> size_t PayloadBytes<std::string>() { return sizeof(std::string) + 65; }
+
+	template<typename Key, typename Value>
+	void ReportFootprint(int capacity)
+	{
+		const size_t payload = PayloadBytes<Key>() + PayloadBytes<Value>();
+		std::cout << "=== " << TypeName<Key>() << " -> " << TypeName<Value>() << " [capacity=" << capacity
+			<< ", payload=" << payload << " B/entry] ===\n";
+		std::cout << std::left << std::setw(14) << "policy" << std::right << std::setw(10) << "entries"
+			<< std::setw(13) << "bytes/entry" << std::setw(11) << "overhead" << std::setw(14) << "entries/MiB"
+			<< std::setw(10) << "vs LRU" << "\n";
+
+		double lru_bytes = 0.0;
+		bool over_capacity = false;
+		for (const auto& policy : AllPolicies<Key, Value>())
+		{
+			size_t before = g_liveBytes.load(std::memory_order_relaxed);
+			auto cache = policy.second(capacity);
+			for (int i = 0; i < capacity * 4; ++i)
+			{
+				Value value = MakeValue<Value>(i);
+				cache->Put(i, value);
+				cache->Put(i, value);
+			}
+			// the misses a warm cache also sees; they fill LRU-K's history and Adaptive's shadows
+			Value missed{};
+			for (int i = 0; i < capacity * 4; ++i)
+				cache->Get(capacity * 4 + i, missed);
+
+			size_t live = g_liveBytes.load(std::memory_order_relaxed) - before;
+			// distinct keys still readable, probed after the heap was measured: Size() counts a key ARC holds
+			// in both its recency and frequency parts twice
+			size_t resident = 0;
+			for (int i = 0; i < capacity * 4; ++i)
+				resident += cache->Get(i, missed);
+			size_t entries = std::max<size_t>(1, resident);
+			double per_entry = static_cast<double>(live) / entries;
+			if (lru_bytes == 0.0)
+				lru_bytes = per_entry;
+
+			std::cout << std::left << std::setw(14) << policy.first << std::right << std::setw(10) << resident
+				<< std::fixed << std::setprecision(1) << std::setw(13) << per_entry
+				<< std::setw(11) << per_entry - payload
+				<< std::setprecision(0) << std::setw(14) << (1024.0 * 1024.0) / per_entry
+				<< std::setprecision(2) << std::setw(9) << lru_bytes / per_entry << "x";
+			if (resident > static_cast<size_t>(capacity))
+			{
+				over_capacity = true;
+				std::cout << " *";
+			}
+			std::cout << "\n";
+		}
+		if (over_capacity)
+			std::cout << "* holds more distinct keys than its capacity (ARC gives each half the full capacity)\n";
+	}
+}
+
+int main(int argc, char** argv) {
+	const int capacity = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+
+	Bench::ReportFootprint<int, int>(capacity);
+	Bench::ReportFootprint<int, Bench::Record32>(capacity);
+	Bench::ReportFootprint<int, std::string>(capacity);
+
+	return 0;
+}
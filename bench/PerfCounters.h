@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Bench {
+
+	enum class Counter
+	{
+		Cycles,
+		Instructions,
+		LLCMisses,
+		BranchMisses,
+	};
+
+	constexpr size_t COUNTER_COUNT = 4;
+
+	inline const char* CounterName(Counter counter)
+	{
+		switch (counter)
+		{
+		case Counter::Cycles: return "cycles";
+		case Counter::Instructions: return "instr";
+		case Counter::LLCMisses: return "LLC-miss";
+		default: return "br-miss";
+		}
+	}
+
+	struct CounterSample
+	{
+		std::array<double, COUNTER_COUNT> values{};
+		std::array<bool, COUNTER_COUNT> valid{};
+
+		double Get(Counter counter) const { return values[static_cast<size_t>(counter)]; }
+		bool Has(Counter counter) const { return valid[static_cast<size_t>(counter)]; }
+	};
+
+	// User-space hardware counters for the calling thread via perf_event_open.
+	// Every counter is opened on its own, so a PMU that lacks one event (or a VM that exposes none) only
+	// loses those columns. When the kernel has to multiplex, values are scaled by enabled/running time.
+	// Elsewhere, or when perf_event_paranoid forbids it, nothing is available and callers report time only.
+	class PerfCounters
+	{
+	public:
+		PerfCounters()
+		{
+			m_fds.fill(-1);
+#if defined(__linux__)
+			_Open(Counter::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+			_Open(Counter::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+			// the generic cache-miss event is the last-level cache on the usual x86 and ARM PMUs
+			_Open(Counter::LLCMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			_Open(Counter::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#else
+			m_error = "perf_event_open is Linux-only";
+#endif
+		}
+
+		~PerfCounters()
+		{
+#if defined(__linux__)
+			for (int fd : m_fds)
+			{
+				if (fd >= 0)
+					close(fd);
+			}
+#endif
+		}
+
+		PerfCounters(const PerfCounters&) = delete;
+		PerfCounters& operator=(const PerfCounters&) = delete;
+
+		bool Available(Counter counter) const { return m_fds[static_cast<size_t>(counter)] >= 0; }
+
+		bool AnyAvailable() const
+		{
+			for (int fd : m_fds)
+			{
+				if (fd >= 0)
+					return true;
+			}
+			return false;
+		}
+
+		// why the first counter that failed could not be opened, empty if all opened
+		const std::string& Error() const { return m_error; }
+
+		void Start()
+		{
+#if defined(__linux__)
+			for (int fd : m_fds)
+			{
+				if (fd < 0)
+					continue;
+				ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		CounterSample Stop()
+		{
+			CounterSample sample;
+#if defined(__linux__)
+			for (size_t i = 0; i < COUNTER_COUNT; ++i)
+			{
+				if (m_fds[i] >= 0)
+					ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+			}
+			for (size_t i = 0; i < COUNTER_COUNT; ++i)
+			{
+				if (m_fds[i] < 0)
+					continue;
+
+				uint64_t data[3] = {};   // value, time enabled, time running
+				if (read(m_fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+					continue;
+				sample.values[i] = static_cast<double>(data[0]) * data[1] / data[2];
+				sample.valid[i] = true;
+			}
+#endif
+			return sample;
+		}
+
+	private:
+#if defined(__linux__)
+		void _Open(Counter counter, uint32_t type, uint64_t config)
+		{
+			perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+			if (fd < 0 && m_error.empty())
+				m_error = std::string(CounterName(counter)) + ": " + std::strerror(errno);
+			m_fds[static_cast<size_t>(counter)] = fd;
+		}
+#endif
+
+	private:
+		std::array<int, COUNTER_COUNT> m_fds;
+		std::string m_error;
+	};
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CachePolicy.h"
+#include "LRU.h"
+#include "LFU.h"
+#include "ARC.h"
+#include "LIRS.h"
+#include "TwoQueue.h"
+#include "GDSF.h"
+#include "Adaptive.h"
+#include "SeqlockHash.h"
+#include "Compact.h"
+
+namespace Bench {
+
+	template<typename Key, typename Value>
+	using CacheFactory = std::function<std::unique_ptr<CacheCpp::ICachePolicy<Key, Value>>(int)>;
+
+	template<typename Key, typename Value>
+	using NamedPolicy = std::pair<std::string, CacheFactory<Key, Value>>;
+
+	// Every policy the benchmarks compare, built for one capacity.
+	template<typename Key, typename Value>
+	std::vector<NamedPolicy<Key, Value>> AllPolicies()
+	{
+		std::vector<NamedPolicy<Key, Value>> policies;
+		policies.emplace_back("LRU", [](int c) { return std::make_unique<CacheCpp::LRUCache<Key, Value>>(c); });
+		if constexpr (CacheCpp::IS_COMPACT_ENTRY<Key, Value>)
+			policies.emplace_back("LRU-Compact", [](int c) { return std::make_unique<CacheCpp::CompactLRUCache<Key, Value>>(c); });
+		policies.emplace_back("LRU-K", [](int c) { return std::make_unique<CacheCpp::LRUKCache<Key, Value>>(c, c * 4, 2); });
+		policies.emplace_back("LRU-Hash", [](int c) { return std::make_unique<CacheCpp::LRUHashCache<Key, Value>>(c, 4); });
+		policies.emplace_back("LRU-Hash+L1", [](int c) { return std::make_unique<CacheCpp::LRUHashCache<Key, Value>>(c, 4, true); });
+		// the default maxAverageNum re-halves every count almost on every access once the cache is warm
+		policies.emplace_back("LFU", [](int c) { return std::make_unique<CacheCpp::LFUCache<Key, Value>>(c, 900000); });
+		policies.emplace_back("ARC", [](int c) { return std::make_unique<CacheCpp::ARCCache<Key, Value>>(c); });
+		policies.emplace_back("LIRS", [](int c) { return std::make_unique<CacheCpp::LIRSCache<Key, Value>>(c); });
+		policies.emplace_back("2Q", [](int c) { return std::make_unique<CacheCpp::TwoQueueCache<Key, Value>>(c); });
+		policies.emplace_back("GDSF", [](int c) { return std::make_unique<CacheCpp::GDSFCache<Key, Value>>(c); });
+		policies.emplace_back("Adaptive", [](int c) { return std::make_unique<CacheCpp::AdaptiveCache<Key, Value>>(c); });
+		policies.emplace_back("Seqlock-Hash", [](int c) { return std::make_unique<CacheCpp::SeqlockHashCache<Key, Value>>(c, 4); });
+		return policies;
+	}
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PerfCounters.h"
+#include "Policies.h"
+
+// Per-operation cost of every policy, one scenario at a time:
+//   hit           Get on a resident key
+//   miss          Get on a key that was never inserted
+//   update        Put on a resident key
+//   insert+evict  Put on a new key into a full cache (for LRU-K, the K-th reference, so it is admitted)
+// Each scenario runs `operations` calls back to back between one counter start/stop, and the totals are
+// divided by the call count, so the syscall cost of reading the counters is amortised away.
+// Usage: CacheBench [capacity] [operations]
+
+namespace Bench {
+
+	enum class Scenario
+	{
+		Hit,
+		Miss,
+		Update,
+		InsertEvict,
+	};
+
+	inline const char* ScenarioName(Scenario scenario)
+	{
+		switch (scenario)
+		{
+		case Scenario::Hit: return "hit";
+		case Scenario::Miss: return "miss";
+		case Scenario::Update: return "update";
+		default: return "insert+evict";
+		}
+	}
+
+	template<typename T> T MakeKey(int index);
+	template<> int MakeKey<int>(int index) { return index; }
+	template<> std::string MakeKey<std::string>(int index)
+	{
+		// 16 bytes: past libstdc++'s small-string buffer, like most real keys
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "user:%011d", index);
+		return buffer;
+	}
+
+	template<typename T> T MakeValue(int index);
+	template<> int MakeValue<int>(int index) { return index; }
+	template<> std::string MakeValue<std::string>(int index) { return std::string(64, static_cast<char>('a' + index % 26)); }
+
+	template<typename T> const char* TypeName();
+	template<> const char* TypeName<int>() { return "int"; }
+	template<> const char* TypeName<std::string>() { return "string"; }
+
+	// every value read lands here so the optimiser cannot drop the Gets
+	volatile size_t g_sink = 0;
+
+	template<typename T> size_t Consume(const T& value) { return static_cast<size_t>(value); }
+	template<> size_t Consume<std::string>(const std::string& value) { return value.size(); }
+
+	template<typename Key, typename Value>
+	class PolicyBench
+	{
+	public:
+		using Cache = CacheCpp::ICachePolicy<Key, Value>;
+
+		PolicyBench(PerfCounters& counters, int capacity, int operations)
+			: m_counters(counters), m_capacity(capacity), m_operations(operations)
+		{
+			std::mt19937 gen(42);
+			for (int i = 0; i < capacity; ++i)
+				m_resident.push_back(MakeKey<Key>(i));
+			for (int i = 0; i < operations; ++i)
+			{
+				m_order.push_back(static_cast<int>(gen() % capacity));
+				// far past the resident range and distinct from one another
+				m_fresh.push_back(MakeKey<Key>(capacity * 16 + i));
+				m_values.push_back(MakeValue<Value>(i));
+			}
+		}
+
+		void Run()
+		{
+			std::cout << "=== " << TypeName<Key>() << " -> " << TypeName<Value>() << " [capacity=" << m_capacity
+				<< ", ops/scenario=" << m_operations << "] ===\n";
+			_PrintHeader();
+
+			for (const auto& policy : AllPolicies<Key, Value>())
+				_RunPolicy(policy.first, policy.second);
+		}
+
+	private:
+		struct Measurement
+		{
+			double nanoseconds;
+			CounterSample counters;
+		};
+
+		template<typename Body>
+		Measurement _Measure(Body body)
+		{
+			m_counters.Start();
+			auto start = std::chrono::steady_clock::now();
+			body();
+			auto end = std::chrono::steady_clock::now();
+			Measurement measurement{ std::chrono::duration<double, std::nano>(end - start).count(), m_counters.Stop() };
+			return measurement;
+		}
+
+		// a counter stays valid only if every part measured it
+		static void _Accumulate(Measurement& total, const Measurement& part, bool first)
+		{
+			if (first)
+			{
+				total = part;
+				return;
+			}
+			total.nanoseconds += part.nanoseconds;
+			for (size_t i = 0; i < COUNTER_COUNT; ++i)
+			{
+				total.counters.values[i] += part.counters.values[i];
+				total.counters.valid[i] = total.counters.valid[i] && part.counters.valid[i];
+			}
+		}
+
+		void _RunPolicy(const std::string& name, const CacheFactory<Key, Value>& makeCache)
+		{
+			std::unique_ptr<Cache> cache = makeCache(m_capacity);
+			// twice, so admission-filtered policies (LRU-K) hold the keys too
+			for (int round = 0; round < 2; ++round)
+			{
+				for (int i = 0; i < m_capacity; ++i)
+					cache->Put(m_resident[i], m_values[i % m_operations]);
+			}
+
+			size_t hits = 0;
+			Value value{};
+			Measurement hit = _Measure([&] {
+				for (int i = 0; i < m_operations; ++i)
+				{
+					if (cache->Get(m_resident[m_order[i]], value))
+					{
+						++hits;
+						g_sink += Consume(value);
+					}
+				}
+			});
+			_PrintRow(name, Scenario::Hit, hit, 100.0 * hits / m_operations);
+
+			Measurement update = _Measure([&] {
+				for (int i = 0; i < m_operations; ++i)
+					cache->Put(m_resident[m_order[i]], m_values[i]);
+			});
+			_PrintRow(name, Scenario::Update, update, -1.0);
+
+			hits = 0;
+			Measurement miss = _Measure([&] {
+				for (int i = 0; i < m_operations; ++i)
+					hits += cache->Get(m_fresh[i], value);
+			});
+			_PrintRow(name, Scenario::Miss, miss, 100.0 * hits / m_operations);
+
+			// one capacity of fresh keys at a time, each read once untimed first: LRU-K's history then holds their
+			// first reference, so the timed Put is the K-th and really inserts and evicts instead of only
+			// recording history; for the other policies the extra reads are plain misses
+			Measurement insert{};
+			for (int begin = 0; begin < m_operations; begin += m_capacity)
+			{
+				int end = std::min(m_operations, begin + m_capacity);
+				for (int i = begin; i < end; ++i)
+					cache->Get(m_fresh[i], value);
+				Measurement chunk = _Measure([&] {
+					for (int i = begin; i < end; ++i)
+						cache->Put(m_fresh[i], m_values[i]);
+				});
+				_Accumulate(insert, chunk, begin == 0);
+			}
+			_PrintRow(name, Scenario::InsertEvict, insert, -1.0);
+		}
+
+		void _PrintHeader() const
+		{
+			std::cout << std::left << std::setw(13) << "policy" << std::setw(13) << "operation" << std::right
+				<< std::setw(9) << "ns/op";
+			for (size_t i = 0; i < COUNTER_COUNT; ++i)
+				std::cout << std::setw(10) << CounterName(static_cast<Counter>(i));
+			std::cout << std::setw(8) << "hit%" << "\n";
+		}
+
+		void _PrintRow(const std::string& name, Scenario scenario, const Measurement& measurement, double hitRate) const
+		{
+			std::cout << std::left << std::setw(13) << name << std::setw(13) << ScenarioName(scenario) << std::right
+				<< std::fixed << std::setprecision(1) << std::setw(9) << measurement.nanoseconds / m_operations;
+			for (size_t i = 0; i < COUNTER_COUNT; ++i)
+			{
+				Counter counter = static_cast<Counter>(i);
+				if (measurement.counters.Has(counter))
+					std::cout << std::setw(10) << std::setprecision(counter == Counter::LLCMisses ? 3 : 1)
+						<< measurement.counters.Get(counter) / m_operations;
+				else
+					std::cout << std::setw(10) << "-";
+			}
+			if (hitRate >= 0.0)
+				std::cout << std::setw(8) << std::setprecision(1) << hitRate;
+			std::cout << "\n";
+		}
+
+	private:
+		PerfCounters& m_counters;
+		int m_capacity;
+		int m_operations;
+		std::vector<Key> m_resident;
+		std::vector<Key> m_fresh;
+		std::vector<Value> m_values;
+		std::vector<int> m_order;
+	};
+}
+
+int main(int argc, char** argv) {
+	const int capacity = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4096;
+	const int operations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 100000;
+
+	Bench::PerfCounters counters;
+	if (!counters.AnyAvailable())
+		std::cout << "hardware counters unavailable (" << counters.Error() << "), reporting time only\n";
+	else if (!counters.Error().empty())
+		std::cout << "some hardware counters unavailable (" << counters.Error() << ")\n";
+
+	Bench::PolicyBench<int, int>(counters, capacity, operations).Run();
+	Bench::PolicyBench<int, std::string>(counters, capacity, operations).Run();
+	Bench::PolicyBench<std::string, std::string>(counters, capacity, operations).Run();
+
+	return 0;
+}
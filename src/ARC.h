@@ -5,6 +5,7 @@
 
 #include "Node.h"  
 #include "CachePolicy.h"  
+#include "LFU.h"  
 #include "LRU.h" 
 
 namespace CacheCpp {  
@@ -21,17 +22,34 @@ namespace CacheCpp {
         {
         }
 
-        bool Put(const Key& key, const Value& value)
+        bool Put(const Key& key, const Value& value) { return Emplace(key, value); }
+
+        bool Put(const Key& key, Value&& value) { return Emplace(key, std::move(value)); }
+
+        template<typename... Args>
+        bool Emplace(const Key& key, Args&&... args)
         {
             if (m_capacity == 0) return false;
-            if (m_lfuMain->Size() >= m_capacity)
+            bool full = m_lfuMain->Size() >= m_capacity;
+            m_lfuMain->Emplace(key, std::forward<Args>(args)...);
+            if (full)
             {
-                m_lfuGhost->Put(key, value);
+                NodePtr node = m_lfuMain->Find(key);
+                if (node != nullptr)
+                    m_lfuGhost->Put(key, node->GetValue());
             }
-            m_lfuMain->Put(key, value);
             return true;
         }
 
+        NodePtr Find(const Key& key) { return m_lfuMain->Find(key); }
+
+        bool Contains(const Key& key) { return m_lfuMain->Contains(key); }
+
+        void SetEvictionCallback(typename ICachePolicy<Key, Value>::EvictionCallback callback)
+        {
+            m_lfuMain->SetEvictionCallback(std::move(callback));
+        }
+
         bool Get(const Key& key, Value& value)
         {
             return m_lfuMain->Get(key, value);
@@ -89,17 +107,34 @@ namespace CacheCpp {
         {
         }
 
-        bool Put(const Key& key, const Value& value)
+        bool Put(const Key& key, const Value& value) { return Emplace(key, value); }
+
+        bool Put(const Key& key, Value&& value) { return Emplace(key, std::move(value)); }
+
+        template<typename... Args>
+        bool Emplace(const Key& key, Args&&... args)
         {
             if (m_capacity == 0) return false;
-            if (m_lruMain->Size() >= m_capacity)
+            bool full = m_lruMain->Size() >= m_capacity;
+            m_lruMain->Emplace(key, std::forward<Args>(args)...);
+            if (full)
             {
-                m_lruGhost->Put(key, value);
+                NodePtr node = m_lruMain->Find(key);
+                if (node != nullptr)
+                    m_lruGhost->Put(key, node->GetValue());
             }
-            m_lruMain->Put(key, value);
             return true;
         }
 
+        NodePtr Find(const Key& key) { return m_lruMain->Find(key); }
+
+        bool Contains(const Key& key) { return m_lruMain->Contains(key); }
+
+        void SetEvictionCallback(typename ICachePolicy<Key, Value>::EvictionCallback callback)
+        {
+            m_lruMain->SetEvictionCallback(std::move(callback));
+        }
+
         bool Get(const Key& key, Value& value, bool& shouldTransform)
         {
             if (m_lruMain->Get(key, value))
@@ -157,6 +192,8 @@ namespace CacheCpp {
    class ARCCache : public ICachePolicy<Key, Value>  
    {  
    public:  
+       using typename ICachePolicy<Key, Value>::NodePtr;
+
        ARCCache(int capacity, int transformThreshold = 10)  
            : m_capacity(capacity), m_ghostCapacity(capacity), m_transformThreshold(transformThreshold),  
            m_lfu(std::make_unique<ArcLFUCache<Key, Value>>(capacity,capacity)),
@@ -164,18 +201,28 @@ namespace CacheCpp {
        {  
        }  
 
-       void Put(const Key& key, const Value& value) override  
+       void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+       void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+       template<typename... Args>
+       void Emplace(const Key& key, Args&&... args)
        {  
            std::lock_guard<std::mutex> lock(m_mutex);
            bool in_ghost = _CheckInGhost(key);  
            if (in_ghost)
            {
-               m_lru->Put(key, value);
+               m_lru->Emplace(key, std::forward<Args>(args)...);
            }
            else  
            {  
-               if (m_lru->Put(key, value))
-                   m_lfu->Put(key, value);
+               // build once in the LRU side, the LFU side gets a copy of the stored value
+               if (m_lru->Emplace(key, std::forward<Args>(args)...))
+               {
+                   NodePtr node = m_lru->Find(key);
+                   if (node != nullptr)
+                       m_lfu->Put(key, node->GetValue());
+               }
            }  
        }  
 
@@ -204,6 +251,27 @@ namespace CacheCpp {
 
        virtual size_t Capacity() const override { return m_capacity; }  
 
+       // An entry can sit in both halves; it is only reported once the other half no longer holds it either,
+       // so a TieredCache never demotes an entry that is still in memory.
+       virtual void SetEvictionCallback(typename ICachePolicy<Key, Value>::EvictionCallback callback) override
+       {
+           if (!callback)
+           {
+               m_lru->SetEvictionCallback(nullptr);
+               m_lfu->SetEvictionCallback(nullptr);
+               return;
+           }
+           // runs under ARC's own lock, so the other half cannot change meanwhile
+           m_lru->SetEvictionCallback([this, callback](const Key& key, const Value& value) {
+               if (!m_lfu->Contains(key))
+                   callback(key, value);
+           });
+           m_lfu->SetEvictionCallback([this, callback](const Key& key, const Value& value) {
+               if (!m_lru->Contains(key))
+                   callback(key, value);
+           });
+       }
+
    private:  
        bool _CheckInGhost(const Key& key)  
        {  
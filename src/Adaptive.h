@@ -0,0 +1,572 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Node.h"
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	// Replacement decisions over keys alone, so one policy can steer a cache that stores the values itself
+	// and a shadow copy can be simulated without any payload.
+	// The owner keeps Size() within its own capacity by calling Evict() before Insert().
+	template<typename Key>
+	class KeyPolicy
+	{
+	public:
+		using KeyNode = Node<Key, bool>;
+		using KeyNodePtr = std::shared_ptr<KeyNode>;
+
+		virtual ~KeyPolicy() {};
+
+		virtual bool Contains(const Key& key) const = 0;
+
+		// key is resident and was referenced
+		virtual void Touch(const Key& key) = 0;
+
+		// key is not resident
+		virtual void Insert(const Key& key) = 0;
+
+		// picks a victim, drops it and returns it; false if nothing is resident
+		virtual bool Evict(Key& victim) = 0;
+
+		virtual void Erase(const Key& key) = 0;
+
+		virtual size_t Size() const = 0;
+	};
+
+	template<typename Key>
+	class LRUKeyPolicy : public KeyPolicy<Key>
+	{
+	public:
+		using typename KeyPolicy<Key>::KeyNode;
+		using typename KeyPolicy<Key>::KeyNodePtr;
+
+		LRUKeyPolicy() : m_list(std::make_unique<LinkedList<Key, bool>>()) {}
+
+		bool Contains(const Key& key) const override { return m_nodes.find(key) != m_nodes.end(); }
+
+		void Touch(const Key& key) override
+		{
+			auto it = m_nodes.find(key);
+			if (it == m_nodes.end())
+				return;
+			m_list->RemoveNode(it->second);
+			m_list->InsertNode(it->second);
+		}
+
+		void Insert(const Key& key) override
+		{
+			KeyNodePtr node = std::make_shared<KeyNode>(key, false);
+			m_list->InsertNode(node);
+			m_nodes[key] = node;
+		}
+
+		bool Evict(Key& victim) override
+		{
+			KeyNodePtr least_recent = m_list->GetLastNode();
+			if (!least_recent)
+				return false;
+			victim = least_recent->GetKey();
+			m_list->RemoveNode(least_recent);
+			m_nodes.erase(victim);
+			return true;
+		}
+
+		void Erase(const Key& key) override
+		{
+			auto it = m_nodes.find(key);
+			if (it == m_nodes.end())
+				return;
+			m_list->RemoveNode(it->second);
+			m_nodes.erase(it);
+		}
+
+		size_t Size() const override { return m_nodes.size(); }
+
+	private:
+		std::unordered_map<Key, KeyNodePtr> m_nodes;
+		std::unique_ptr<LinkedList<Key, bool>> m_list;   // GetLastNode() is the least recent
+	};
+
+	// Least frequently used, least recent first among equal counts.
+	// Counts are halved every AGING_FACTOR * capacity references, so keys that were popular in an earlier
+	// phase lose their lead instead of pinning the cache forever.
+	template<typename Key>
+	class LFUKeyPolicy : public KeyPolicy<Key>
+	{
+	public:
+		using typename KeyPolicy<Key>::KeyNode;
+		using typename KeyPolicy<Key>::KeyNodePtr;
+
+		static constexpr size_t AGING_FACTOR = 8;
+
+		explicit LFUKeyPolicy(size_t capacity)
+			: m_agingPeriod(std::max<size_t>(1, capacity) * AGING_FACTOR), m_references(0)
+		{
+		}
+
+		bool Contains(const Key& key) const override { return m_nodes.find(key) != m_nodes.end(); }
+
+		void Touch(const Key& key) override
+		{
+			auto it = m_nodes.find(key);
+			if (it == m_nodes.end())
+				return;
+			_Unlink(it->second);
+			it->second->IncrementAccessCount();
+			_Link(it->second);
+			if (++m_references >= m_agingPeriod)
+				_Age();
+		}
+
+		void Insert(const Key& key) override
+		{
+			KeyNodePtr node = std::make_shared<KeyNode>(key, false);
+			m_nodes[key] = node;
+			_Link(node);
+		}
+
+		bool Evict(Key& victim) override
+		{
+			if (m_freqLists.empty())
+				return false;
+			KeyNodePtr node = m_freqLists.begin()->second->GetLastNode();
+			victim = node->GetKey();
+			_Unlink(node);
+			m_nodes.erase(victim);
+			return true;
+		}
+
+		void Erase(const Key& key) override
+		{
+			auto it = m_nodes.find(key);
+			if (it == m_nodes.end())
+				return;
+			_Unlink(it->second);
+			m_nodes.erase(it);
+		}
+
+		size_t Size() const override { return m_nodes.size(); }
+
+	private:
+		void _Link(const KeyNodePtr& node)
+		{
+			auto& list = m_freqLists[node->GetAccessCount()];
+			if (!list)
+				list = std::make_unique<LinkedList<Key, bool>>();
+			list->InsertNode(node);
+		}
+
+		void _Unlink(const KeyNodePtr& node)
+		{
+			auto it = m_freqLists.find(node->GetAccessCount());
+			it->second->RemoveNode(node);
+			if (it->second->IsEmpty())
+				m_freqLists.erase(it);
+		}
+
+		// Halves every count (never below 1) and rebuilds the lists. Lists are drained oldest first, lowest
+		// count first, so recency order within each merged count is kept.
+		void _Age()
+		{
+			m_references = 0;
+			std::map<size_t, std::unique_ptr<LinkedList<Key, bool>>> old_lists;
+			old_lists.swap(m_freqLists);
+			for (auto& entry : old_lists)
+			{
+				while (KeyNodePtr node = entry.second->GetLastNode())
+				{
+					entry.second->RemoveNode(node);
+					node->SetAccessCount(std::max<size_t>(1, node->GetAccessCount() / 2));
+					_Link(node);
+				}
+			}
+		}
+
+	private:
+		size_t m_agingPeriod;
+		size_t m_references;
+		std::unordered_map<Key, KeyNodePtr> m_nodes;
+		std::map<size_t, std::unique_ptr<LinkedList<Key, bool>>> m_freqLists;   // begin() is the lowest count
+	};
+
+	// S3-FIFO (Yang et al.)
+	// New keys enter a small FIFO; on leaving it they move to the main FIFO if they were referenced meanwhile,
+	// otherwise they are evicted and remembered in a ghost FIFO. Ghost hits go straight to main. Main is a
+	// FIFO with reinsertion: a key with a nonzero (2-bit) count is put back with its count decremented.
+	template<typename Key>
+	class S3FIFOKeyPolicy : public KeyPolicy<Key>
+	{
+	public:
+		using typename KeyPolicy<Key>::KeyNode;
+		using typename KeyPolicy<Key>::KeyNodePtr;
+
+		static constexpr size_t MAX_FREQ = 3;
+
+		// capacity is the owner's; the small queue gets smallRatio of it and the ghost remembers as many keys
+		S3FIFOKeyPolicy(size_t capacity, double smallRatio = 0.1)
+			: m_smallCapacity(std::max<size_t>(1, static_cast<size_t>(capacity * smallRatio))),
+			m_ghostCapacity(std::max<size_t>(1, capacity)), m_smallCount(0),
+			m_small(std::make_unique<LinkedList<Key, bool>>()),
+			m_main(std::make_unique<LinkedList<Key, bool>>()),
+			m_ghost(std::make_unique<LinkedList<Key, bool>>())
+		{
+		}
+
+		bool Contains(const Key& key) const override { return m_nodes.find(key) != m_nodes.end(); }
+
+		void Touch(const Key& key) override
+		{
+			auto it = m_nodes.find(key);
+			if (it == m_nodes.end())
+				return;
+			// counts start at 1 (Node's default), so the stored count is frequency + 1
+			if (it->second->GetAccessCount() <= MAX_FREQ)
+				it->second->IncrementAccessCount();
+		}
+
+		void Insert(const Key& key) override
+		{
+			KeyNodePtr node = std::make_shared<KeyNode>(key, false);
+			auto ghost = m_ghosts.find(key);
+			if (ghost != m_ghosts.end())
+			{
+				m_ghost->RemoveNode(ghost->second);
+				m_ghosts.erase(ghost);
+				node->SetValue(true);
+				m_main->InsertNode(node);
+			}
+			else
+			{
+				m_small->InsertNode(node);
+				++m_smallCount;
+			}
+			m_nodes[key] = node;
+		}
+
+		bool Evict(Key& victim) override
+		{
+			while (!m_nodes.empty())
+			{
+				if (m_smallCount >= m_smallCapacity || m_main->IsEmpty())
+				{
+					KeyNodePtr oldest = m_small->GetLastNode();
+					m_small->RemoveNode(oldest);
+					--m_smallCount;
+					if (oldest->GetAccessCount() > 1)
+					{
+						oldest->SetAccessCount(1);
+						oldest->SetValue(true);
+						m_main->InsertNode(oldest);
+						continue;
+					}
+					victim = oldest->GetKey();
+					m_nodes.erase(victim);
+					_RememberEvicted(victim);
+					return true;
+				}
+
+				KeyNodePtr oldest = m_main->GetLastNode();
+				m_main->RemoveNode(oldest);
+				if (oldest->GetAccessCount() > 1)
+				{
+					oldest->SetAccessCount(oldest->GetAccessCount() - 1);
+					m_main->InsertNode(oldest);
+					continue;
+				}
+				victim = oldest->GetKey();
+				m_nodes.erase(victim);
+				return true;
+			}
+			return false;
+		}
+
+		void Erase(const Key& key) override
+		{
+			auto it = m_nodes.find(key);
+			if (it == m_nodes.end())
+				return;
+			if (it->second->GetValue())
+			{
+				m_main->RemoveNode(it->second);
+			}
+			else
+			{
+				m_small->RemoveNode(it->second);
+				--m_smallCount;
+			}
+			m_nodes.erase(it);
+		}
+
+		size_t Size() const override { return m_nodes.size(); }
+
+	private:
+		void _RememberEvicted(const Key& key)
+		{
+			KeyNodePtr ghost = std::make_shared<KeyNode>(key, false);
+			m_ghost->InsertNode(ghost);
+			m_ghosts[key] = ghost;
+			if (m_ghosts.size() > m_ghostCapacity)
+			{
+				KeyNodePtr oldest = m_ghost->GetLastNode();
+				m_ghost->RemoveNode(oldest);
+				m_ghosts.erase(oldest->GetKey());
+			}
+		}
+
+	private:
+		size_t m_smallCapacity;
+		size_t m_ghostCapacity;
+		size_t m_smallCount;
+
+		std::unordered_map<Key, KeyNodePtr> m_nodes;    // node value: true = main, false = small
+		std::unordered_map<Key, KeyNodePtr> m_ghosts;
+		std::unique_ptr<LinkedList<Key, bool>> m_small;  // GetLastNode() is the oldest
+		std::unique_ptr<LinkedList<Key, bool>> m_main;   // GetLastNode() is the oldest
+		std::unique_ptr<LinkedList<Key, bool>> m_ghost;  // GetLastNode() is the oldest
+	};
+
+	enum class AdaptiveCandidate
+	{
+		LRU,
+		LFU,
+		S3FIFO,
+	};
+
+	inline const char* CandidateName(AdaptiveCandidate candidate)
+	{
+		switch (candidate)
+		{
+		case AdaptiveCandidate::LRU: return "LRU";
+		case AdaptiveCandidate::LFU: return "LFU";
+		default: return "S3-FIFO";
+		}
+	}
+
+	struct AdaptiveOptions
+	{
+		int sampleRate = 16;          // Gets for 1 in N keys (by hash) are replayed against the shadow sets
+		int windowSize = 256;         // sampled accesses per duel round
+		double decay = 0.5;           // weight of earlier rounds in the running score
+		double switchMargin = 0.05;   // challenger must beat the current policy's hit rate by this much
+		AdaptiveCandidate initial = AdaptiveCandidate::LRU;
+	};
+
+	// Set-dueling meta-policy
+	// Every candidate policy runs on a shadow set: key-only metadata for a hash-sampled 1/sampleRate of the
+	// keys, sized capacity/sampleRate, so each shadow sees a scaled-down copy of the real traffic.
+	// Every windowSize sampled accesses the shadows' hit rates are folded into decayed scores, and the
+	// main cache hands its eviction decisions to the best one once it leads the current policy by
+	// switchMargin (the margin is the hysteresis that stops it flapping between close candidates).
+	// The main cache keeps every candidate's metadata up to date for its own keys, so a switch is instant
+	// and the new policy starts with full history.
+	template<typename Key, typename Value>
+	class AdaptiveCache : public ICachePolicy<Key, Value>
+	{
+	public:
+		static constexpr size_t CANDIDATES = 3;
+		static constexpr int MIN_SHADOW_CAPACITY = 32;
+
+		AdaptiveCache(int capacity, const AdaptiveOptions& options = AdaptiveOptions())
+			: m_capacity(capacity), m_options(options), m_active(options.initial), m_switches(0),
+			m_windowAccesses(0), m_rounds(0)
+		{
+			// sample less aggressively for small caches so the shadows don't degenerate to a handful of keys
+			int rate = std::max(1, options.sampleRate);
+			while (rate > 1 && capacity / rate < MIN_SHADOW_CAPACITY)
+				rate /= 2;
+			m_sampleRate = rate;
+			size_t shadow_capacity = std::max(1, capacity / rate);
+
+			m_policies = _MakeCandidates(std::max(1, capacity));
+			m_shadows = _MakeCandidates(shadow_capacity);
+			m_shadowCapacity = shadow_capacity;
+			m_windowHits.fill(0);
+			m_scores.fill(0.0);
+		}
+
+		virtual ~AdaptiveCache() override = default;
+
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
+		{
+			if (m_capacity <= 0)
+				return;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_values.find(key);
+			if (it != m_values.end())
+			{
+				AssignValue(it->second, std::forward<Args>(args)...);
+				for (auto& policy : m_policies)
+					policy->Touch(key);
+				return;
+			}
+
+			if (m_values.size() >= static_cast<size_t>(m_capacity))
+				_EvictEntry();
+
+			m_values.try_emplace(key, std::forward<Args>(args)...);
+			for (auto& policy : m_policies)
+				policy->Insert(key);
+		}
+
+		bool Get(const Key& key, Value& value) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			_Sample(key);
+			auto it = m_values.find(key);
+			if (it == m_values.end())
+				return false;
+
+			value = it->second;
+			for (auto& policy : m_policies)
+				policy->Touch(key);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_values.erase(key) == 0)
+				return;
+			for (auto& policy : m_policies)
+				policy->Erase(key);
+		}
+
+		virtual size_t Size() const override { return m_values.size(); }
+
+		virtual size_t Capacity() const override { return m_capacity; }
+
+		AdaptiveCandidate ActivePolicy()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_active;
+		}
+
+		size_t Switches()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_switches;
+		}
+
+	private:
+		using Candidates = std::array<std::unique_ptr<KeyPolicy<Key>>, CANDIDATES>;
+
+		static Candidates _MakeCandidates(size_t capacity)
+		{
+			Candidates candidates;
+			candidates[static_cast<size_t>(AdaptiveCandidate::LRU)] = std::make_unique<LRUKeyPolicy<Key>>();
+			candidates[static_cast<size_t>(AdaptiveCandidate::LFU)] = std::make_unique<LFUKeyPolicy<Key>>(capacity);
+			candidates[static_cast<size_t>(AdaptiveCandidate::S3FIFO)] = std::make_unique<S3FIFOKeyPolicy<Key>>(capacity);
+			return candidates;
+		}
+
+		// the active policy picks the victim, the others only forget it
+		void _EvictEntry()
+		{
+			Key victim;
+			if (!m_policies[static_cast<size_t>(m_active)]->Evict(victim))
+				return;
+			for (size_t i = 0; i < CANDIDATES; ++i)
+			{
+				if (i != static_cast<size_t>(m_active))
+					m_policies[i]->Erase(victim);
+			}
+
+			auto it = m_values.find(victim);
+			this->_NotifyEvicted(victim, it->second);
+			m_values.erase(it);
+		}
+
+		// Replays a sampled Get against every shadow as a read-through cache would see it (a miss inserts).
+		void _Sample(const Key& key)
+		{
+			if (m_sampleRate > 1 && _Mix(std::hash<Key>{}(key)) % m_sampleRate != 0)
+				return;
+
+			for (size_t i = 0; i < CANDIDATES; ++i)
+			{
+				KeyPolicy<Key>& shadow = *m_shadows[i];
+				if (shadow.Contains(key))
+				{
+					shadow.Touch(key);
+					++m_windowHits[i];
+					continue;
+				}
+				if (shadow.Size() >= m_shadowCapacity)
+				{
+					Key victim;
+					shadow.Evict(victim);
+				}
+				shadow.Insert(key);
+			}
+
+			if (++m_windowAccesses >= static_cast<size_t>(m_options.windowSize))
+				_EndRound();
+		}
+
+		void _EndRound()
+		{
+			// the first round has no history to blend with
+			double keep = m_rounds++ == 0 ? 0.0 : m_options.decay;
+			for (size_t i = 0; i < CANDIDATES; ++i)
+			{
+				double hit_rate = static_cast<double>(m_windowHits[i]) / m_windowAccesses;
+				m_scores[i] = keep * m_scores[i] + (1.0 - keep) * hit_rate;
+				m_windowHits[i] = 0;
+			}
+			m_windowAccesses = 0;
+
+			size_t best = static_cast<size_t>(m_active);
+			for (size_t i = 0; i < CANDIDATES; ++i)
+			{
+				if (m_scores[i] > m_scores[best])
+					best = i;
+			}
+			if (best != static_cast<size_t>(m_active)
+				&& m_scores[best] > m_scores[static_cast<size_t>(m_active)] + m_options.switchMargin)
+			{
+				m_active = static_cast<AdaptiveCandidate>(best);
+				++m_switches;
+			}
+		}
+
+		static uint64_t _Mix(uint64_t x)
+		{
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			return x ^ (x >> 31);
+		}
+
+	private:
+		int m_capacity;
+		AdaptiveOptions m_options;
+		int m_sampleRate;
+		size_t m_shadowCapacity;
+
+		std::mutex m_mutex;
+		std::unordered_map<Key, Value> m_values;
+		Candidates m_policies;   // all track the resident keys; only m_active chooses victims
+		Candidates m_shadows;    // key-only, sampled keys only
+		AdaptiveCandidate m_active;
+		size_t m_switches;
+
+		std::array<size_t, CANDIDATES> m_windowHits;
+		std::array<double, CANDIDATES> m_scores;   // decayed shadow hit rates
+		size_t m_windowAccesses;
+		size_t m_rounds;
+	};
+}
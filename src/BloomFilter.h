@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace CacheCpp {
+
+	// Counting Bloom filter over key hashes, for answering "definitely absent" without a lock.
+	// Each key bumps HASHES saturating 8-bit counters; a counter that reaches 255 is never decremented again,
+	// which can only cost false positives, never false negatives.
+	// Add/Erase must be serialised by the caller; MayContain can run concurrently with them.
+	class CountingBloomFilter
+	{
+	public:
+		static constexpr int HASHES = 4;
+		static constexpr uint8_t SATURATED = UINT8_MAX;
+
+		// ~2.4% false positives at 8 counters per key when the filter holds expectedKeys keys
+		CountingBloomFilter(size_t expectedKeys, int countersPerKey)
+		{
+			size_t wanted = std::max<size_t>(64, expectedKeys * std::max(1, countersPerKey));
+			size_t size = 64;
+			while (size < wanted)
+				size <<= 1;
+
+			m_mask = size - 1;
+			m_counters = std::make_unique<std::atomic<uint8_t>[]>(size);
+			for (size_t i = 0; i < size; ++i)
+				m_counters[i].store(0, std::memory_order_relaxed);
+		}
+
+		void Add(size_t hash)
+		{
+			uint64_t h1, h2;
+			_Split(hash, h1, h2);
+			for (int i = 0; i < HASHES; ++i)
+			{
+				auto& counter = m_counters[(h1 + i * h2) & m_mask];
+				uint8_t count = counter.load(std::memory_order_relaxed);
+				if (count != SATURATED)
+					counter.store(count + 1, std::memory_order_relaxed);
+			}
+		}
+
+		void Erase(size_t hash)
+		{
+			uint64_t h1, h2;
+			_Split(hash, h1, h2);
+			for (int i = 0; i < HASHES; ++i)
+			{
+				auto& counter = m_counters[(h1 + i * h2) & m_mask];
+				uint8_t count = counter.load(std::memory_order_relaxed);
+				if (count != SATURATED && count != 0)
+					counter.store(count - 1, std::memory_order_relaxed);
+			}
+		}
+
+		bool MayContain(size_t hash) const
+		{
+			uint64_t h1, h2;
+			_Split(hash, h1, h2);
+			for (int i = 0; i < HASHES; ++i)
+			{
+				if (m_counters[(h1 + i * h2) & m_mask].load(std::memory_order_relaxed) == 0)
+					return false;
+			}
+			return true;
+		}
+
+		size_t Counters() const { return m_mask + 1; }
+
+	private:
+		// std::hash is the identity for integers, so remix before deriving the probe sequence
+		static void _Split(size_t hash, uint64_t& h1, uint64_t& h2)
+		{
+			uint64_t x = static_cast<uint64_t>(hash) + 0x9e3779b97f4a7c15ULL;
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			x ^= x >> 31;
+			h1 = x;
+			h2 = (x >> 32) | 1;   // odd stride visits distinct counters
+		}
+
+	private:
+		size_t m_mask;
+		std::unique_ptr<std::atomic<uint8_t>[]> m_counters;
+	};
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <functional>
 #include <unordered_map>
+#include <utility>
 #include "Node.h"
 
 namespace CacheCpp {
@@ -12,11 +14,22 @@ public:
     using NodeType = Node<Key, Value>;
     using NodePtr = std::shared_ptr<NodeType>;
     using NodeMap = std::unordered_map<Key, NodePtr>;
+    using EvictionCallback = std::function<void(const Key&, const Value&)>;
 
     virtual ~ICachePolicy() {};
 
     virtual void Put(const Key& key, const Value& value) = 0;
 
+    virtual void Put(const Key& key, Value&& value) = 0;
+
+    // Through the interface the value is built once and moved in.
+    // Concrete caches hide this with an Emplace that constructs the value inside the node itself.
+    template<typename... Args>
+    void Emplace(const Key& key, Args&&... args)
+    {
+        Put(key, Value(std::forward<Args>(args)...));
+    }
+
     virtual bool Get(const Key& key, Value& value) = 0;
 
     virtual void Remove(const Key& key) = 0;
@@ -24,6 +37,18 @@ public:
     virtual size_t Size() const = 0;
 
     virtual size_t Capacity() const = 0;
+
+    // Invoked for every entry evicted to make room (not for Remove), under the policy's lock.
+    virtual void SetEvictionCallback(EvictionCallback callback) { m_onEvict = std::move(callback); }
+
+protected:
+    void _NotifyEvicted(const Key& key, const Value& value)
+    {
+        if (m_onEvict)
+            m_onEvict(key, value);
+    }
+
+    EvictionCallback m_onEvict;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Node.h"
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	// Types that can live by value in a preallocated array: copied with memcpy, never own heap memory.
+	template<typename T>
+	struct IsCompactStorable
+		: std::bool_constant<std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>>
+	{
+	};
+
+	template<typename Key, typename Value>
+	constexpr bool IS_COMPACT_ENTRY = IsCompactStorable<Key>::value && IsCompactStorable<Value>::value;
+
+	// LRU for trivially copyable keys and values, with no per-entry allocation.
+	// All entries are preallocated in one array and chained into the recency list by 32-bit indices; the index
+	// is an open-addressing table of entry indices (linear probing, load factor at most three quarters,
+	// backward-shift deletion so no tombstones build up). An int -> int entry costs 16 bytes plus 5-11 bytes of
+	// index, where LRUCache spends a shared_ptr node, its control block and an unordered_map node on it.
+	// Same behaviour and callbacks as LRUCache; prefer LRUCacheFor, which picks this class when it applies.
+	template<typename Key, typename Value>
+	class CompactLRUCache : public ICachePolicy<Key, Value>
+	{
+		static_assert(IS_COMPACT_ENTRY<Key, Value>, "CompactLRUCache needs trivially copyable keys and values");
+
+	public:
+		// true: key became resident, false: key left (evicted or removed); runs under the cache lock
+		using MembershipCallback = std::function<void(const Key&, bool)>;
+
+		static constexpr uint32_t NIL = UINT32_MAX;
+
+		CompactLRUCache(int capacity)
+			: m_capacity(capacity > 0 ? capacity : 0),
+			m_entries(m_capacity),
+			m_index(_IndexSize(m_capacity), NIL),
+			m_mask(m_index.size() - 1),
+			m_head(NIL), m_tail(NIL), m_free(m_capacity > 0 ? 0 : NIL), m_size(0)
+		{
+			// unused entries form the free list through their next links
+			for (size_t i = 0; i < m_capacity; ++i)
+				m_entries[i].next = i + 1 < m_capacity ? static_cast<uint32_t>(i + 1) : NIL;
+		}
+
+		virtual ~CompactLRUCache() override = default;
+
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
+		{
+			if (m_capacity == 0)
+				return;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			size_t slot = _FindSlot(key);
+			if (m_index[slot] != NIL)
+			{
+				uint32_t index = m_index[slot];
+				AssignValue(m_entries[index].value, std::forward<Args>(args)...);
+				_MoveToMostRecent(index);
+				return;
+			}
+
+			if (m_size >= m_capacity)
+			{
+				_EvictEntry();
+				// backward shifts may have moved the probe sequence's end
+				slot = _FindSlot(key);
+			}
+			if (m_onMembership)
+				m_onMembership(key, true);
+
+			uint32_t index = m_free;
+			Entry& entry = m_entries[index];
+			m_free = entry.next;
+			entry.key = key;
+			AssignValue(entry.value, std::forward<Args>(args)...);
+			_PushFront(index);
+			m_index[slot] = index;
+			++m_size;
+		}
+
+		bool Get(const Key& key, Value& value) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_capacity == 0)
+				return false;
+
+			uint32_t index = m_index[_FindSlot(key)];
+			if (index == NIL)
+				return false;
+			value = m_entries[index].value;
+			_MoveToMostRecent(index);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_capacity == 0)
+				return;
+
+			size_t slot = _FindSlot(key);
+			uint32_t index = m_index[slot];
+			if (index == NIL)
+				return;
+
+			_Unlink(index);
+			_EraseSlot(slot);
+			_Release(index);
+			if (m_onMembership)
+				m_onMembership(key, false);
+		}
+
+		virtual size_t Size() const override { return m_size; }
+
+		virtual size_t Capacity() const override { return m_capacity; }
+
+		bool Contains(const Key& key)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_capacity > 0 && m_index[_FindSlot(key)] != NIL;
+		}
+
+		// Get without touching recency
+		bool Peek(const Key& key, Value& value)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_capacity == 0)
+				return false;
+
+			uint32_t index = m_index[_FindSlot(key)];
+			if (index == NIL)
+				return false;
+			value = m_entries[index].value;
+			return true;
+		}
+
+		void SetMembershipCallback(MembershipCallback callback)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_onMembership = std::move(callback);
+		}
+
+	private:
+		struct Entry
+		{
+			Key key{};
+			Value value{};
+			uint32_t prev = NIL;
+			uint32_t next = NIL;
+		};
+
+		// smallest power of two holding capacity at a load factor of at most three quarters
+		static size_t _IndexSize(size_t capacity)
+		{
+			size_t size = 2;
+			while (size * 3 < capacity * 4)
+				size <<= 1;
+			return size;
+		}
+
+		static size_t _Hash(const Key& key)
+		{
+			// std::hash is the identity for integers; spread the bits so runs of keys do not cluster
+			uint64_t x = static_cast<uint64_t>(std::hash<Key>{}(key));
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			return static_cast<size_t>(x ^ (x >> 31));
+		}
+
+		// slot holding key's entry, or the empty slot that ends its probe sequence
+		size_t _FindSlot(const Key& key) const
+		{
+			size_t slot = _Hash(key) & m_mask;
+			while (m_index[slot] != NIL && !(m_entries[m_index[slot]].key == key))
+				slot = (slot + 1) & m_mask;
+			return slot;
+		}
+
+		// Knuth's deletion for linear probing: pull later entries of the run back over the hole as long as
+		// that does not move them in front of their home slot
+		void _EraseSlot(size_t slot)
+		{
+			size_t hole = slot;
+			for (size_t next = (hole + 1) & m_mask; m_index[next] != NIL; next = (next + 1) & m_mask)
+			{
+				size_t home = _Hash(m_entries[m_index[next]].key) & m_mask;
+				if (((next - home) & m_mask) >= ((next - hole) & m_mask))
+				{
+					m_index[hole] = m_index[next];
+					hole = next;
+				}
+			}
+			m_index[hole] = NIL;
+		}
+
+		void _PushFront(uint32_t index)
+		{
+			Entry& entry = m_entries[index];
+			entry.prev = NIL;
+			entry.next = m_head;
+			if (m_head != NIL)
+				m_entries[m_head].prev = index;
+			else
+				m_tail = index;
+			m_head = index;
+		}
+
+		void _Unlink(uint32_t index)
+		{
+			Entry& entry = m_entries[index];
+			if (entry.prev != NIL)
+				m_entries[entry.prev].next = entry.next;
+			else
+				m_head = entry.next;
+			if (entry.next != NIL)
+				m_entries[entry.next].prev = entry.prev;
+			else
+				m_tail = entry.prev;
+		}
+
+		void _MoveToMostRecent(uint32_t index)
+		{
+			if (index == m_head)
+				return;
+			_Unlink(index);
+			_PushFront(index);
+		}
+
+		void _Release(uint32_t index)
+		{
+			m_entries[index].next = m_free;
+			m_free = index;
+			--m_size;
+		}
+
+		void _EvictEntry()
+		{
+			uint32_t victim = m_tail;
+			if (victim == NIL)
+				return;
+
+			const Entry& entry = m_entries[victim];
+			_Unlink(victim);
+			_EraseSlot(_FindSlot(entry.key));
+			if (m_onMembership)
+				m_onMembership(entry.key, false);
+			// the entry is only reused once it is back on the free list
+			this->_NotifyEvicted(entry.key, entry.value);
+			_Release(victim);
+		}
+
+	private:
+		size_t m_capacity;
+		std::vector<Entry> m_entries;
+		std::vector<uint32_t> m_index;   // entry index per slot, NIL = empty
+		size_t m_mask;
+		uint32_t m_head;                 // most recent
+		uint32_t m_tail;                 // next to evict
+		uint32_t m_free;
+		size_t m_size;
+		std::mutex m_mutex;
+		MembershipCallback m_onMembership;
+	};
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace CacheCpp {
+
+	// Epoch-based reclamation for structures whose readers take no locks.
+	// Readers pin the current global epoch for the length of a Guard; writers unlink a node first and then
+	// Retire() it. A node retired in epoch e is only freed once the global epoch has reached e + 2, which
+	// cannot happen while any reader that might still hold it is pinned.
+	// One process-wide domain; every thread gets a record on first use and gives it back when it exits.
+	class EpochDomain
+	{
+		struct Record;
+
+	public:
+		using Deleter = void (*)(void*);
+
+		static constexpr size_t RECLAIM_INTERVAL = 64;   // retirements between reclamation passes
+
+		static EpochDomain& Global()
+		{
+			static EpochDomain domain;
+			return domain;
+		}
+
+		// Pins the calling thread's epoch; nested guards on one thread only pin once.
+		class Guard
+		{
+		public:
+			explicit Guard(EpochDomain& domain = Global()) : m_domain(domain), m_record(domain._ThreadRecord())
+			{
+				if (m_record->depth++ == 0)
+				{
+					m_record->epoch.store(m_domain.m_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					// the announcement must be visible before this thread loads any shared pointer
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+				}
+			}
+
+			~Guard()
+			{
+				if (--m_record->depth == 0)
+					m_record->epoch.store(0, std::memory_order_release);
+			}
+
+			Guard(const Guard&) = delete;
+			Guard& operator=(const Guard&) = delete;
+
+		private:
+			EpochDomain& m_domain;
+			Record* m_record;
+		};
+
+		// ptr must already be unreachable for readers that start from now on.
+		void Retire(void* ptr, Deleter deleter)
+		{
+			Record* record = _ThreadRecord();
+			record->retired.push_back(Retired{ ptr, deleter, m_epoch.load(std::memory_order_acquire) });
+			if (++record->sinceReclaim < RECLAIM_INTERVAL)
+				return;
+
+			record->sinceReclaim = 0;
+			_TryAdvance();
+			_Reclaim(record->retired);
+
+			std::unique_lock<std::mutex> lock(m_orphanMutex, std::try_to_lock);
+			if (lock.owns_lock() && !m_orphans.empty())
+				_Reclaim(m_orphans);
+		}
+
+		template<typename T>
+		void Retire(T* ptr)
+		{
+			Retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+		}
+
+		uint64_t Epoch() const { return m_epoch.load(std::memory_order_relaxed); }
+
+		~EpochDomain()
+		{
+			// only reached at exit, after every other thread is gone
+			Record* record = m_records.load(std::memory_order_acquire);
+			while (record)
+			{
+				Record* next = record->next;
+				_FreeAll(record->retired);
+				delete record;
+				record = next;
+			}
+			_FreeAll(m_orphans);
+		}
+
+	private:
+		struct Retired
+		{
+			void* ptr;
+			Deleter deleter;
+			uint64_t epoch;
+		};
+
+		struct alignas(64) Record
+		{
+			std::atomic<uint64_t> epoch{ 0 };   // pinned epoch, 0 = not inside a Guard
+			std::atomic<bool> inUse{ true };
+			Record* next = nullptr;             // records are never unlinked, only recycled
+			int depth = 0;
+			size_t sinceReclaim = 0;
+			std::vector<Retired> retired;       // owned by the thread holding the record
+		};
+
+		// gives the record back when its thread exits; what it still has retired is adopted by the domain
+		struct RecordHolder
+		{
+			EpochDomain* domain = nullptr;
+			Record* record = nullptr;
+
+			~RecordHolder()
+			{
+				if (!record)
+					return;
+				{
+					std::lock_guard<std::mutex> lock(domain->m_orphanMutex);
+					domain->m_orphans.insert(domain->m_orphans.end(), record->retired.begin(), record->retired.end());
+				}
+				record->retired.clear();
+				record->sinceReclaim = 0;
+				record->epoch.store(0, std::memory_order_relaxed);
+				record->inUse.store(false, std::memory_order_release);
+			}
+		};
+
+		EpochDomain() : m_epoch(1), m_records(nullptr) {}
+
+		Record* _ThreadRecord()
+		{
+			static thread_local RecordHolder holder;
+			if (holder.record)
+				return holder.record;
+
+			holder.domain = this;
+			for (Record* record = m_records.load(std::memory_order_acquire); record; record = record->next)
+			{
+				bool expected = false;
+				if (!record->inUse.load(std::memory_order_relaxed)
+					&& record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+				{
+					holder.record = record;
+					return record;
+				}
+			}
+
+			Record* record = new Record();
+			record->next = m_records.load(std::memory_order_relaxed);
+			while (!m_records.compare_exchange_weak(record->next, record, std::memory_order_release,
+				std::memory_order_relaxed))
+			{
+			}
+			holder.record = record;
+			return record;
+		}
+
+		// The epoch moves on only once every pinned thread has seen the current one.
+		void _TryAdvance()
+		{
+			uint64_t current = m_epoch.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			for (Record* record = m_records.load(std::memory_order_acquire); record; record = record->next)
+			{
+				uint64_t pinned = record->epoch.load(std::memory_order_acquire);
+				if (pinned != 0 && pinned != current)
+					return;
+			}
+			m_epoch.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel);
+		}
+
+		void _Reclaim(std::vector<Retired>& retired)
+		{
+			uint64_t safe = m_epoch.load(std::memory_order_acquire);
+			size_t kept = 0;
+			for (const Retired& node : retired)
+			{
+				if (node.epoch + 2 <= safe)
+					node.deleter(node.ptr);
+				else
+					retired[kept++] = node;
+			}
+			retired.resize(kept);
+		}
+
+		static void _FreeAll(std::vector<Retired>& retired)
+		{
+			for (const Retired& node : retired)
+				node.deleter(node.ptr);
+			retired.clear();
+		}
+
+	private:
+		alignas(64) std::atomic<uint64_t> m_epoch;
+		std::atomic<Record*> m_records;
+
+		std::mutex m_orphanMutex;
+		std::vector<Retired> m_orphans;   // retired by threads that have exited
+	};
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Node.h"
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	// GreedyDual-Size-Frequency
+	// Every entry has priority H = L + frequency * cost / size, where cost is what a miss on the key costs
+	// (latency, CPU, ...) and size its footprint. The entry with the lowest H is evicted and the inflation
+	// clock L jumps to that H, so entries that stop being referenced age out relative to fresh ones.
+	// Entries sit in an indexed min-heap on H: Get, Put and eviction are O(log n).
+	template<typename Key, typename Value>
+	class GDSFCache : public ICachePolicy<Key, Value>
+	{
+	public:
+		using typename ICachePolicy<Key, Value>::NodeType;
+		using typename ICachePolicy<Key, Value>::NodePtr;
+
+		static constexpr double DEFAULT_COST = 1.0;
+		static constexpr size_t DEFAULT_SIZE = 1;
+
+		// capacity: max entries
+		// maxBytes: optional budget on the summed entry sizes, 0 = entries only; a value larger than the whole
+		//           budget is not cached, and an update to such a value drops the key's old entry
+		GDSFCache(int capacity, size_t maxBytes = 0)
+			: m_capacity(capacity), m_maxBytes(maxBytes), m_bytes(0), m_clock(0.0), m_sequence(0)
+		{
+			m_heap.reserve(capacity > 0 ? capacity : 0);
+		}
+
+		virtual ~GDSFCache() override = default;
+
+		// Without a cost the policy degrades to frequency + inflation (every miss costs the same).
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		void Put(const Key& key, const Value& value, double cost, size_t size = DEFAULT_SIZE)
+		{
+			_Put(key, cost, size, value);
+		}
+
+		void Put(const Key& key, Value&& value, double cost, size_t size = DEFAULT_SIZE)
+		{
+			_Put(key, cost, size, std::move(value));
+		}
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
+		{
+			_Put(key, DEFAULT_COST, DEFAULT_SIZE, std::forward<Args>(args)...);
+		}
+
+		bool Get(const Key& key, Value& value) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (it == m_caches.end())
+				return false;
+
+			value = it->second.node->GetValue();
+			_Touch(it->second);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (it == m_caches.end())
+				return;
+
+			_RemoveFromHeap(it->second.heapIndex);
+			m_bytes -= it->second.size;
+			m_caches.erase(it);
+		}
+
+		virtual size_t Size() const override { return m_caches.size(); }
+
+		virtual size_t Capacity() const override { return m_capacity; }
+
+		size_t Bytes() const { return m_bytes; }
+
+		// Current inflation value L, i.e. the priority of the last evicted entry.
+		double Clock() const { return m_clock; }
+
+	private:
+		struct Entry
+		{
+			NodePtr node;        // value and reference count
+			double cost;
+			size_t size;
+			double priority;
+			uint64_t sequence;   // last reference, breaks priority ties in LRU order
+			size_t heapIndex;
+		};
+
+		template<typename... Args>
+		void _Put(const Key& key, double cost, size_t size, Args&&... args)
+		{
+			if (m_capacity <= 0)
+				return;
+			size = std::max<size_t>(size, 1);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (m_maxBytes > 0 && size > m_maxBytes)
+			{
+				// the new value can never fit, and the old one is stale now, so it has to go too
+				if (it != m_caches.end())
+				{
+					NodePtr node = it->second.node;
+					_RemoveFromHeap(it->second.heapIndex);
+					m_bytes -= it->second.size;
+					m_caches.erase(it);
+					this->_NotifyEvicted(node->GetKey(), node->GetValue());
+				}
+				return;
+			}
+			if (it != m_caches.end())
+			{
+				Entry& entry = it->second;
+				entry.node->EmplaceValue(std::forward<Args>(args)...);
+				m_bytes = m_bytes - entry.size + size;
+				entry.cost = cost;
+				entry.size = size;
+				_Touch(entry);
+				_EvictOverBudget(&entry);
+				return;
+			}
+
+			while (!m_heap.empty() && (m_caches.size() >= static_cast<size_t>(m_capacity)
+				|| (m_maxBytes > 0 && m_bytes + size > m_maxBytes)))
+			{
+				_EvictNode();
+			}
+
+			Entry& entry = m_caches[key];
+			entry.node = std::make_shared<NodeType>(key, std::forward<Args>(args)...);
+			entry.cost = cost;
+			entry.size = size;
+			m_bytes += size;
+			entry.priority = _Priority(entry);
+			entry.sequence = ++m_sequence;
+			entry.heapIndex = m_heap.size();
+			m_heap.push_back(&entry);
+			_SiftUp(entry.heapIndex);
+		}
+
+		void _Touch(Entry& entry)
+		{
+			entry.node->IncrementAccessCount();
+			entry.priority = _Priority(entry);
+			entry.sequence = ++m_sequence;
+			// usually the priority only grows, but an update may have lowered the cost
+			_SiftDown(entry.heapIndex);
+			_SiftUp(entry.heapIndex);
+		}
+
+		double _Priority(const Entry& entry) const
+		{
+			return m_clock + entry.node->GetAccessCount() * entry.cost / entry.size;
+		}
+
+		// an update that grew an entry may push the cache over maxBytes; never evict the entry being written
+		void _EvictOverBudget(const Entry* keep)
+		{
+			while (m_maxBytes > 0 && m_bytes > m_maxBytes && m_heap.size() > 1)
+			{
+				if (m_heap.front() == keep)
+				{
+					// the updated entry is the cheapest: drop the cheaper of the root's children instead
+					size_t victim = m_heap.size() > 2 && _Less(m_heap[2], m_heap[1]) ? 2 : 1;
+					_EvictAt(victim);
+					continue;
+				}
+				_EvictAt(0);
+			}
+		}
+
+		void _EvictNode() { _EvictAt(0); }
+
+		void _EvictAt(size_t heapIndex)
+		{
+			Entry* victim = m_heap[heapIndex];
+			m_clock = std::max(m_clock, victim->priority);
+			NodePtr node = victim->node;
+			m_bytes -= victim->size;
+			_RemoveFromHeap(heapIndex);
+			m_caches.erase(node->GetKey());
+			this->_NotifyEvicted(node->GetKey(), node->GetValue());
+		}
+
+		void _RemoveFromHeap(size_t heapIndex)
+		{
+			size_t last = m_heap.size() - 1;
+			if (heapIndex != last)
+			{
+				_Swap(heapIndex, last);
+				m_heap.pop_back();
+				_SiftDown(heapIndex);
+				_SiftUp(heapIndex);
+			}
+			else
+			{
+				m_heap.pop_back();
+			}
+		}
+
+		static bool _Less(const Entry* a, const Entry* b)
+		{
+			if (a->priority != b->priority)
+				return a->priority < b->priority;
+			return a->sequence < b->sequence;
+		}
+
+		void _SiftUp(size_t pos)
+		{
+			while (pos > 0)
+			{
+				size_t parent = (pos - 1) / 2;
+				if (!_Less(m_heap[pos], m_heap[parent]))
+					break;
+				_Swap(pos, parent);
+				pos = parent;
+			}
+		}
+
+		void _SiftDown(size_t pos)
+		{
+			size_t size = m_heap.size();
+			while (true)
+			{
+				size_t smallest = pos;
+				size_t left = 2 * pos + 1;
+				size_t right = left + 1;
+				if (left < size && _Less(m_heap[left], m_heap[smallest]))
+					smallest = left;
+				if (right < size && _Less(m_heap[right], m_heap[smallest]))
+					smallest = right;
+				if (smallest == pos)
+					break;
+				_Swap(pos, smallest);
+				pos = smallest;
+			}
+		}
+
+		void _Swap(size_t a, size_t b)
+		{
+			std::swap(m_heap[a], m_heap[b]);
+			m_heap[a]->heapIndex = a;
+			m_heap[b]->heapIndex = b;
+		}
+
+	private:
+		int m_capacity;
+		size_t m_maxBytes;
+		size_t m_bytes;
+		double m_clock;        // inflation value L
+		uint64_t m_sequence;
+
+		std::mutex m_mutex;
+		std::unordered_map<Key, Entry> m_caches;   // node-based, so Entry addresses are stable
+		std::vector<Entry*> m_heap;                // min-heap on (priority, sequence)
+	};
+}
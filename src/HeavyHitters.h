@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace CacheCpp {
+
+	template<typename Key>
+	struct HeavyHitter
+	{
+		Key key;
+		size_t count;   // upper bound on the true frequency
+		size_t error;   // count - error is a guaranteed lower bound
+	};
+
+	// Space-Saving top-K frequency tracker (Metwally et al.).
+	// Keeps exactly `capacity` counters; an unseen key takes over the smallest counter and inherits its count
+	// as error. Any key with true frequency above Total() / capacity is guaranteed to be tracked.
+	// Counters sit in an indexed min-heap so Offer is O(log capacity).
+	template<typename Key>
+	class SpaceSaving
+	{
+	public:
+		explicit SpaceSaving(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1), m_total(0)
+		{
+			m_heap.reserve(m_capacity);
+		}
+
+		void Offer(const Key& key, size_t weight = 1)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_total += weight;
+
+			auto it = m_index.find(key);
+			if (it != m_index.end())
+			{
+				m_heap[it->second].count += weight;
+				_SiftDown(it->second);
+				return;
+			}
+
+			if (m_heap.size() < m_capacity)
+			{
+				m_heap.push_back(HeavyHitter<Key>{ key, weight, 0 });
+				m_index[key] = m_heap.size() - 1;
+				_SiftUp(m_heap.size() - 1);
+				return;
+			}
+
+			// evict the minimum counter and hand it to the new key
+			HeavyHitter<Key>& min = m_heap.front();
+			m_index.erase(min.key);
+			min.key = key;
+			min.error = min.count;
+			min.count += weight;
+			m_index[key] = 0;
+			_SiftDown(0);
+		}
+
+		// Highest counts first.
+		std::vector<HeavyHitter<Key>> TopK(size_t k) const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::vector<HeavyHitter<Key>> result(m_heap);
+			k = std::min(k, result.size());
+			std::partial_sort(result.begin(), result.begin() + k, result.end(),
+				[](const HeavyHitter<Key>& a, const HeavyHitter<Key>& b) { return a.count > b.count; });
+			result.resize(k);
+			return result;
+		}
+
+		// Halves every counter so the tracker follows shifting traffic; halving keeps the heap order.
+		void Decay()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (auto& counter : m_heap)
+			{
+				counter.count /= 2;
+				counter.error /= 2;
+			}
+			m_total /= 2;
+		}
+
+		size_t Total() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_total;
+		}
+
+		size_t Capacity() const { return m_capacity; }
+
+	private:
+		void _SiftUp(size_t pos)
+		{
+			while (pos > 0)
+			{
+				size_t parent = (pos - 1) / 2;
+				if (m_heap[parent].count <= m_heap[pos].count)
+					break;
+				_Swap(pos, parent);
+				pos = parent;
+			}
+		}
+
+		void _SiftDown(size_t pos)
+		{
+			size_t size = m_heap.size();
+			while (true)
+			{
+				size_t smallest = pos;
+				size_t left = 2 * pos + 1;
+				size_t right = left + 1;
+				if (left < size && m_heap[left].count < m_heap[smallest].count)
+					smallest = left;
+				if (right < size && m_heap[right].count < m_heap[smallest].count)
+					smallest = right;
+				if (smallest == pos)
+					break;
+				_Swap(pos, smallest);
+				pos = smallest;
+			}
+		}
+
+		void _Swap(size_t a, size_t b)
+		{
+			std::swap(m_heap[a], m_heap[b]);
+			m_index[m_heap[a].key] = a;
+			m_index[m_heap[b].key] = b;
+		}
+
+	private:
+		size_t m_capacity;
+		size_t m_total;
+
+		mutable std::mutex m_mutex;
+		std::vector<HeavyHitter<Key>> m_heap;            // min-heap on count
+		std::unordered_map<Key, size_t> m_index;         // key -> position in m_heap
+	};
+}
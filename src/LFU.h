@@ -1,6 +1,8 @@
 #pragma once
 
 
+#include <algorithm>
+#include <climits>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -32,6 +34,10 @@ namespace CacheCpp {
 	class LFUCache : public ICachePolicy<Key, Value>
 	{
 	public:
+		using typename ICachePolicy<Key, Value>::NodeType;
+		using typename ICachePolicy<Key, Value>::NodePtr;
+		using typename ICachePolicy<Key, Value>::NodeMap;
+
 		LFUCache(int capacity, int maxAverageNum = 10)
 			: m_capacity(capacity), m_minFreq(INT_MAX), m_maxAverageNum(maxAverageNum),
 			m_avgFreq(0), m_totalFreq(0)
@@ -40,7 +46,12 @@ namespace CacheCpp {
 
 		virtual ~LFUCache() override = default;
 
-		void Put(const Key& key, const Value& value) override
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
 		{
 			if (m_capacity < 0)
 				return;
@@ -50,12 +61,12 @@ namespace CacheCpp {
 			auto it = m_caches.find(key);
 			if (it != m_caches.end())
 			{
-				it->second->SetValue(value);
+				it->second->EmplaceValue(std::forward<Args>(args)...);
 				_UpdateExistingNode(it->second);
 				return;
 			}
 
-			_AddNewNode(key, value);
+			_AddNewNode(key, std::forward<Args>(args)...);
 		}
 
 		bool Get(const Key& key, Value& value) override
@@ -110,6 +121,16 @@ namespace CacheCpp {
 			return m_caches.find(key) != m_caches.end();
 		}
 
+		NodePtr Find(const Key& key)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (it != m_caches.end()) {
+				return it->second;
+			}
+			return nullptr;
+		}
+
 		NodePtr GetNodeToEvict()
 		{
 			if (m_freqLists.find(m_minFreq) == m_freqLists.end()) return nullptr;
@@ -121,12 +142,13 @@ namespace CacheCpp {
 			return node;
 		}
 	private:
-		void _AddNewNode(const Key& key, const Value& value)
+		template<typename... Args>
+		void _AddNewNode(const Key& key, Args&&... args)
 		{
 			if (m_caches.size() >= m_capacity)
 				_EvictNode();
 
-			NodePtr new_node = std::make_shared<NodeType>(key, value);
+			NodePtr new_node = std::make_shared<NodeType>(key, std::forward<Args>(args)...);
 			m_caches[key] = new_node;
 			_AddToFreqList(new_node);
 			_UpdateFreqStats(true, 1);
@@ -160,6 +182,7 @@ namespace CacheCpp {
 			_RemoveFromFreqList(node);
 			m_caches.erase(node->GetKey());
 			_UpdateFreqStats(false, node->GetAccessCount());
+			this->_NotifyEvicted(node->GetKey(), node->GetValue());
 		}
 
 		void _RemoveFromFreqList(const NodePtr& node)
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Node.h"
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	// LIRS (Low Inter-reference Recency Set)
+	// Stack S holds every LIR block plus any HIR block (resident or not) that is more recent than the
+	// bottom LIR block. Queue Q holds the resident HIR blocks; its tail is always the victim, so a scan
+	// only ever churns the small HIR partition and never touches the LIR set.
+	template<typename Key, typename Value>
+	class LIRSCache : public ICachePolicy<Key, Value>
+	{
+	public:
+		// bool payload is unused: S, Q and the non-resident list only track keys
+		using KeyNode = Node<Key, bool>;
+		using KeyNodePtr = std::shared_ptr<KeyNode>;
+
+		// hirRatio:           share of capacity given to resident HIR blocks (at least one slot)
+		// nonResidentRatio:   bound on non-resident HIR history, as a multiple of capacity
+		LIRSCache(int capacity, double hirRatio = 0.01, double nonResidentRatio = 1.0)
+			: m_capacity(capacity), m_lirCount(0), m_hirCount(0), m_nonResidentCount(0),
+			m_stack(std::make_unique<LinkedList<Key, bool>>()),
+			m_queue(std::make_unique<LinkedList<Key, bool>>()),
+			m_nonResident(std::make_unique<LinkedList<Key, bool>>())
+		{
+			int hir_capacity = std::max(1, static_cast<int>(capacity * hirRatio));
+			m_lirCapacity = std::max(0, capacity - hir_capacity);
+			m_nonResidentCapacity = std::max(1, static_cast<int>(capacity * nonResidentRatio));
+		}
+
+		virtual ~LIRSCache() override = default;
+
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
+		{
+			if (m_capacity <= 0)
+				return;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_entries.find(key);
+			if (it != m_entries.end() && it->second.status != Status::HirNonResident)
+			{
+				AssignValue(it->second.value, std::forward<Args>(args)...);
+				_OnResidentHit(key, it->second);
+				return;
+			}
+
+			_OnMiss(key, it, std::forward<Args>(args)...);
+		}
+
+		bool Get(const Key& key, Value& value) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_entries.find(key);
+			if (it == m_entries.end() || it->second.status == Status::HirNonResident)
+				return false;
+
+			value = it->second.value;
+			_OnResidentHit(key, it->second);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_entries.find(key);
+			if (it == m_entries.end())
+				return;
+
+			_EraseEntry(it);
+			_PruneStack();
+		}
+
+		virtual size_t Size() const override { return m_lirCount + m_hirCount; }
+
+		virtual size_t Capacity() const override { return m_capacity; }
+
+	private:
+		enum class Status { Lir, HirResident, HirNonResident };
+
+		struct Entry
+		{
+			template<typename... Args>
+			explicit Entry(Args&&... args)
+				: status(Status::HirResident), value(std::forward<Args>(args)...)
+			{
+			}
+
+			Status status;
+			Value value;
+			KeyNodePtr stackNode;   // position in S, null if not in S
+			KeyNodePtr queueNode;   // position in Q (resident HIR) or in the non-resident list
+		};
+
+		using EntryMap = std::unordered_map<Key, Entry>;
+
+		void _OnResidentHit(const Key& key, Entry& entry)
+		{
+			if (entry.status == Status::Lir)
+			{
+				_MoveToStackTop(key, entry);
+				_PruneStack();
+				return;
+			}
+
+			// resident HIR: a hit while still in S means its reuse distance beat the bottom LIR block
+			if (entry.stackNode)
+			{
+				_RemoveFromQueue(entry);
+				_MoveToStackTop(key, entry);
+				_PromoteToLir(entry);
+			}
+			else
+			{
+				_MoveToStackTop(key, entry);
+				m_queue->RemoveNode(entry.queueNode);
+				m_queue->InsertNode(entry.queueNode);
+			}
+		}
+
+		template<typename... Args>
+		void _OnMiss(const Key& key, typename EntryMap::iterator it, Args&&... args)
+		{
+			if (Size() >= static_cast<size_t>(m_capacity))
+				_EvictResidentHir();
+
+			// the eviction above may have trimmed this key's non-resident history
+			if (it != m_entries.end())
+				it = m_entries.find(key);
+
+			if (it != m_entries.end())
+			{
+				// non-resident HIR still in S: bring it back directly as LIR
+				Entry& entry = it->second;
+				_RemoveFromNonResident(entry);
+				AssignValue(entry.value, std::forward<Args>(args)...);
+				_MoveToStackTop(key, entry);
+				_PromoteToLir(entry);
+				return;
+			}
+
+			Entry& entry = m_entries.try_emplace(key, std::forward<Args>(args)...).first->second;
+			_MoveToStackTop(key, entry);
+			if (m_lirCount < m_lirCapacity)
+			{
+				entry.status = Status::Lir;
+				++m_lirCount;
+				_PruneStack();
+			}
+			else
+			{
+				entry.status = Status::HirResident;
+				_PushToQueue(key, entry);
+			}
+		}
+
+		void _PromoteToLir(Entry& entry)
+		{
+			entry.status = Status::Lir;
+			++m_lirCount;
+
+			// demote bottom LIR blocks into Q until the LIR set fits again
+			while (m_lirCount > m_lirCapacity)
+			{
+				_PruneStack();
+				KeyNodePtr bottom = m_stack->GetLastNode();
+				if (!bottom) break;
+
+				Entry& demoted = m_entries.find(bottom->GetKey())->second;
+				m_stack->RemoveNode(bottom);
+				demoted.stackNode = nullptr;
+				demoted.status = Status::HirResident;
+				--m_lirCount;
+				_PushToQueue(bottom->GetKey(), demoted);
+			}
+			_PruneStack();
+		}
+
+		void _EvictResidentHir()
+		{
+			KeyNodePtr victim = m_queue->GetLastNode();
+			if (!victim) return;
+
+			auto it = m_entries.find(victim->GetKey());
+			Entry& entry = it->second;
+			_RemoveFromQueue(entry);
+			this->_NotifyEvicted(victim->GetKey(), entry.value);
+			if (!entry.stackNode)
+			{
+				m_entries.erase(it);
+				return;
+			}
+
+			// keep the key in S as non-resident history, drop the payload
+			entry.status = Status::HirNonResident;
+			entry.value = Value();
+			entry.queueNode = victim;
+			m_nonResident->InsertNode(victim);
+			++m_nonResidentCount;
+			_TrimNonResident();
+		}
+
+		void _TrimNonResident()
+		{
+			while (m_nonResidentCount > m_nonResidentCapacity)
+			{
+				KeyNodePtr oldest = m_nonResident->GetLastNode();
+				if (!oldest) break;
+				_EraseEntry(m_entries.find(oldest->GetKey()));
+			}
+		}
+
+		// S must always have an LIR block at its bottom
+		void _PruneStack()
+		{
+			while (KeyNodePtr bottom = m_stack->GetLastNode())
+			{
+				auto it = m_entries.find(bottom->GetKey());
+				if (it->second.status == Status::Lir)
+					break;
+
+				m_stack->RemoveNode(bottom);
+				it->second.stackNode = nullptr;
+				if (it->second.status == Status::HirNonResident)
+					_EraseEntry(it);
+			}
+		}
+
+		void _EraseEntry(typename EntryMap::iterator it)
+		{
+			Entry& entry = it->second;
+			if (entry.stackNode)
+				m_stack->RemoveNode(entry.stackNode);
+
+			if (entry.status == Status::Lir)
+				--m_lirCount;
+			else if (entry.status == Status::HirResident)
+				_RemoveFromQueue(entry);
+			else
+				_RemoveFromNonResident(entry);
+
+			m_entries.erase(it);
+		}
+
+		void _MoveToStackTop(const Key& key, Entry& entry)
+		{
+			if (entry.stackNode)
+				m_stack->RemoveNode(entry.stackNode);
+			else
+				entry.stackNode = std::make_shared<KeyNode>(key, false);
+			m_stack->InsertNode(entry.stackNode);
+		}
+
+		void _PushToQueue(const Key& key, Entry& entry)
+		{
+			entry.queueNode = std::make_shared<KeyNode>(key, false);
+			m_queue->InsertNode(entry.queueNode);
+			++m_hirCount;
+		}
+
+		void _RemoveFromQueue(Entry& entry)
+		{
+			if (!entry.queueNode) return;
+			m_queue->RemoveNode(entry.queueNode);
+			entry.queueNode = nullptr;
+			--m_hirCount;
+		}
+
+		void _RemoveFromNonResident(Entry& entry)
+		{
+			if (!entry.queueNode) return;
+			m_nonResident->RemoveNode(entry.queueNode);
+			entry.queueNode = nullptr;
+			--m_nonResidentCount;
+		}
+
+	private:
+		int m_capacity;
+		int m_lirCapacity;
+		int m_lirCount;
+		int m_hirCount;       // resident HIR blocks, i.e. the length of Q
+		int m_nonResidentCapacity;
+		int m_nonResidentCount;
+
+		std::mutex m_mutex;
+		EntryMap m_entries;
+		std::unique_ptr<LinkedList<Key, bool>> m_stack;         // S, top at the head
+		std::unique_ptr<LinkedList<Key, bool>> m_queue;         // Q, GetLastNode() is the victim
+		std::unique_ptr<LinkedList<Key, bool>> m_nonResident;   // GetLastNode() is the oldest history
+	};
+}
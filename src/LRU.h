@@ -1,11 +1,24 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "Node.h"
 #include "CachePolicy.h"
+#include "HeavyHitters.h"
+#include "BloomFilter.h"
+#include "Compact.h"
 
 namespace CacheCpp {
 
@@ -13,13 +26,24 @@ namespace CacheCpp {
 	class LRUCache : public ICachePolicy<Key, Value>
 	{
 	public:
+		using typename ICachePolicy<Key, Value>::NodeType;
+		using typename ICachePolicy<Key, Value>::NodePtr;
+		using typename ICachePolicy<Key, Value>::NodeMap;
+		// true: key became resident, false: key left (evicted or removed); runs under the cache lock
+		using MembershipCallback = std::function<void(const Key&, bool)>;
+
 		LRUCache(int capacity) : m_capacity(capacity), m_list(std::make_unique<LinkedList<Key,Value>>())
 		{
 		}
 
 		virtual ~LRUCache() override = default;
 
-		void Put(const Key& key, const Value& value) override
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
 		{
 			if (m_capacity < 0)
 				return;
@@ -28,12 +52,12 @@ namespace CacheCpp {
 			auto it = m_caches.find(key);
 			if (it != m_caches.end())
 			{
-				it->second->SetValue(value);
+				it->second->EmplaceValue(std::forward<Args>(args)...);
 				_MoveToMostRecent(it->second);
 				return;
 			}
 
-			_AddNewNode(key, value);
+			_AddNewNode(key, std::forward<Args>(args)...);
 		}
 
 		bool Get(const Key& key, Value& value) override
@@ -57,6 +81,8 @@ namespace CacheCpp {
 			{
 				m_list->RemoveNode(it->second);
 				m_caches.erase(it);
+				if (m_onMembership)
+					m_onMembership(key, false);
 			}
 		}
 
@@ -91,6 +117,23 @@ namespace CacheCpp {
 			return nullptr;
 		}
 
+		// Get without touching recency
+		bool Peek(const Key& key, Value& value)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (it == m_caches.end())
+				return false;
+			value = it->second->GetValue();
+			return true;
+		}
+
+		void SetMembershipCallback(MembershipCallback callback)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_onMembership = std::move(callback);
+		}
+
 		NodePtr GetNodeToEvict()
 		{
 			NodePtr least_recent = m_list->GetLastNode();
@@ -98,11 +141,15 @@ namespace CacheCpp {
 		}
 
 	private:
-		void _AddNewNode(const Key& key, const Value& value)
+		template<typename... Args>
+		void _AddNewNode(const Key& key, Args&&... args)
 		{
 			if (m_caches.size() >= m_capacity)
 				_EvictNode();
-			NodePtr new_node = std::make_shared<NodeType>(key, value);
+			// announced before the node is reachable so lock-free membership checks never miss it
+			if (m_onMembership)
+				m_onMembership(key, true);
+			NodePtr new_node = std::make_shared<NodeType>(key, std::forward<Args>(args)...);
 			m_list->InsertNode(new_node);
 			m_caches[key] = new_node;
 		}
@@ -121,15 +168,23 @@ namespace CacheCpp {
 
 			m_list->RemoveNode(least_recent);
 			m_caches.erase(least_recent->GetKey());
+			if (m_onMembership)
+				m_onMembership(least_recent->GetKey(), false);
+			this->_NotifyEvicted(least_recent->GetKey(), least_recent->GetValue());
 		}
 
 	private:
 		int m_capacity;
 		NodeMap m_caches;    // value: Node<Key,Value>
 		std::mutex m_mutex;
+		MembershipCallback m_onMembership;
 		std::unique_ptr<CacheCpp::LinkedList<Key, Value>> m_list;   // m_list->GetLastNode() is the node to evict
 	};
 
+	// CompactLRUCache when both types are trivially copyable, LRUCache (which also hands out nodes) otherwise.
+	template<typename Key, typename Value>
+	using LRUCacheFor = std::conditional_t<IS_COMPACT_ENTRY<Key, Value>, CompactLRUCache<Key, Value>, LRUCache<Key, Value>>;
+
 	// optimisation: LRU-K
 	template<typename Key, typename Value>
 	class LRUKCache : public LRUCache<Key, Value>
@@ -137,11 +192,16 @@ namespace CacheCpp {
 	public:
 		LRUKCache(int capacity, int historyCapacity, int k)
 			: LRUCache<Key, Value>(capacity),
-			m_accessHistory(std::make_unique<LRUCache<Key, size_t>>(historyCapacity)), m_k(k)
+			m_accessHistory(std::make_unique<LRUCacheFor<Key, size_t>>(historyCapacity)), m_k(k)
 		{
 		}
 
-		void Put(const Key& key, const Value& value) override
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
 		{
 
 			size_t history_count = _UpdateAccessCount(key);
@@ -149,7 +209,7 @@ namespace CacheCpp {
 			if (history_count >= m_k)
 			{
 				m_accessHistory->Remove(key);
-				LRUCache<Key, Value>::Put(key, value);
+				LRUCache<Key, Value>::Emplace(key, std::forward<Args>(args)...);
 			}
 		}
 
@@ -171,42 +231,207 @@ namespace CacheCpp {
 		}
 	private:
 		int m_k;
-		std::unique_ptr<LRUCache<Key, size_t>> m_accessHistory;
+		std::unique_ptr<LRUCacheFor<Key, size_t>> m_accessHistory;
 	};
 
 
+	struct LRUHashOptions
+	{
+		bool frontCache = false;        // per-thread direct-mapped front cache
+		int hotKeySampleRate = 0;       // feed 1 in N Gets to a Space-Saving tracker, 0 = no tracking
+		int hotKeyReplicas = 0;         // slices each detected hot key is spread over, <= 1 = no replication
+		int maxHotKeys = 16;
+		double hotKeyMinShare = 0.01;   // guaranteed share of sampled Gets a key needs to count as hot
+		int filterCountersPerKey = 0;   // per-slice counting Bloom filter for negative lookups, 0 = off
+	};
+
+	struct NegativeFilterStats
+	{
+		size_t rejected = 0;         // Gets answered "absent" without touching a slice lock
+		size_t falsePositives = 0;   // Gets the filter let through that still missed
+
+		double FalsePositiveRate() const
+		{
+			size_t absent = rejected + falsePositives;
+			return absent ? static_cast<double>(falsePositives) / absent : 0.0;
+		}
+	};
+
 	// Optimisation: 
+	// frontCache: each reader thread gets a small direct-mapped table, owned by the cache and freed with it, holding
+	// copies of what that thread recently read. Every slice carries an epoch that Put/Remove bump after the write
+	// lands; a front slot is only trusted while its slice epoch is unchanged, so repeat hits on hot keys skip the
+	// slice mutex entirely. Threads beyond FRONT_CACHE_THREADS alive at once read through the slices.
+	//
+	// hotKeyReplicas: sampled Gets feed a Space-Saving tracker; keys it reports as hot are copied into the
+	// replica caches of hotKeyReplicas - 1 neighbouring slices and each reader thread picks the primary or one
+	// of the copies, so the hottest keys stop funnelling every reader through a single mutex. Replica caches
+	// are separate small LRUs, so copies take neither capacity nor Size() from the slices. Writes to a hot key
+	// go to all of its copies under an exclusive m_hotMutex; the primary slice is always authoritative, a
+	// missing replica falls back to it, and every Nth replica hit also reads the primary so the hottest keys
+	// keep their place in its LRU order.
+	//
+	// filterCountersPerKey: every slice keeps a counting Bloom filter of its resident keys, maintained under
+	// the slice lock as keys enter and leave. A Get whose key the primary slice's filter rules out returns
+	// a miss without locking anything.
 	template<typename Key, typename Value>
 	class LRUHashCache : public ICachePolicy<Key, Value>
 	{
 	public:
-		LRUHashCache(int capacity, int sliceNum)
+		using typename ICachePolicy<Key, Value>::NodePtr;
+
+		static constexpr size_t FRONT_CACHE_SLOTS = 256;
+		static constexpr size_t FRONT_CACHE_THREADS = 64;
+		// every Nth front hit on a slot still goes to the slice so hot keys keep their LRU position
+		static constexpr uint32_t FRONT_CACHE_REFRESH = 32;
+		static constexpr size_t HOT_TABLE_SLOTS = 64;
+		static constexpr size_t HOT_REFRESH_INTERVAL = 4096;   // samples between hot set refreshes
+		// every Nth replica hit on a thread also reads the primary copy
+		static constexpr uint32_t REPLICA_REFRESH = 16;
+
+		LRUHashCache(int capacity, int sliceNum, bool frontCache = false)
+			: LRUHashCache(capacity, sliceNum, LRUHashOptions{ frontCache })
+		{
+		}
+
+		LRUHashCache(int capacity, int sliceNum, const LRUHashOptions& options)
 			: m_capacity(capacity),
-			m_sliceNum(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
+			m_sliceNum(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()),
+			m_frontCache(options.frontCache),
+			m_epochs(m_sliceNum),
+			m_sampleRate(options.hotKeySampleRate),
+			m_replicas(std::min(options.hotKeyReplicas, m_sliceNum)),
+			m_maxHotKeys(std::max(1, std::min(options.maxHotKeys, static_cast<int>(HOT_TABLE_SLOTS / 2)))),
+			m_hotKeyMinShare(options.hotKeyMinShare),
+			m_samples(0)
 		{
 			size_t slice_size = std::ceil(capacity / static_cast<double>(m_sliceNum));
 			for (int i = 0; i < m_sliceNum; ++i)
 			{
-				m_sliceCaches.emplace_back(std::make_unique<LRUCache<Key, Value>>(slice_size));
+				m_sliceCaches.emplace_back(std::make_unique<LRUCacheFor<Key, Value>>(slice_size));
 			}
+
+			if (options.filterCountersPerKey > 0)
+			{
+				for (int i = 0; i < m_sliceNum; ++i)
+				{
+					m_filters.emplace_back(std::make_unique<SliceFilter>(slice_size, options.filterCountersPerKey));
+					SliceFilter* filter = m_filters.back().get();
+					m_sliceCaches[i]->SetMembershipCallback([this, filter](const Key& key, bool resident) {
+						if (resident)
+							filter->filter.Add(_Hash(key));
+						else
+							filter->filter.Erase(_Hash(key));
+					});
+				}
+			}
+
+			if (m_sampleRate > 0)
+				m_tracker = std::make_unique<SpaceSaving<Key>>(m_maxHotKeys * 8);
+			if (_Replicating())
+			{
+				// a slice's replica cache holds copies of hot keys from its neighbours, never more than the hot set
+				for (int i = 0; i < m_sliceNum; ++i)
+					m_replicaCaches.emplace_back(std::make_unique<LRUCacheFor<Key, Value>>(m_maxHotKeys));
+			}
+			for (auto& slot : m_hotHashes)
+				slot.store(0, std::memory_order_relaxed);
+			if (m_frontCache)
+				m_frontCaches.resize(FRONT_CACHE_THREADS);
 		}
 
-		void Put(const Key& key, const Value& value) override
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
 		{
 			size_t slice_index = _Hash(key) % m_sliceNum;
-			m_sliceCaches[slice_index]->Put(key, value);
+			if (!_Replicating())
+			{
+				m_sliceCaches[slice_index]->Emplace(key, std::forward<Args>(args)...);
+				_BumpEpoch(slice_index);
+				return;
+			}
+
+			std::shared_lock<std::shared_mutex> shared(m_hotMutex);
+			if (m_hotKeys.find(key) == m_hotKeys.end())
+			{
+				m_sliceCaches[slice_index]->Emplace(key, std::forward<Args>(args)...);
+				_BumpEpoch(slice_index);
+				return;
+			}
+			shared.unlock();
+
+			// front slots are keyed on the primary epoch, so bump it only once every copy is current
+			std::unique_lock<std::shared_mutex> exclusive(m_hotMutex);
+			m_sliceCaches[slice_index]->Emplace(key, std::forward<Args>(args)...);
+			if (m_hotKeys.find(key) != m_hotKeys.end())
+				_CopyToReplicas(key, slice_index);
+			_BumpEpoch(slice_index);
 		}
 
 		bool Get(const Key& key, Value& value) override
 		{
-			size_t slice_index = _Hash(key) % m_sliceNum;
-			return m_sliceCaches[slice_index]->Get(key, value);
+			size_t hash = _Hash(key);
+			size_t slice_index = hash % m_sliceNum;
+			if (m_tracker)
+				_SampleHotKey(key);
+			if (!m_frontCache)
+				return _GetFromSlices(key, hash, slice_index, value);
+
+			// read the epoch before the slice: a write racing with the fill leaves the slot already stale
+			uint64_t epoch = m_epochs[slice_index].value.load(std::memory_order_acquire);
+			FrontSlot* slot = _GetFrontSlot(hash);
+			if (!slot)
+				return _GetFromSlices(key, hash, slice_index, value);
+			if (slot->entry && slot->epoch == epoch && slot->entry->first == key
+				&& ++slot->hits % FRONT_CACHE_REFRESH != 0)
+			{
+				value = slot->entry->second;
+				return true;
+			}
+
+			if (!_GetFromSlices(key, hash, slice_index, value))
+				return false;
+
+			slot->epoch = epoch;
+			slot->hits = 0;
+			if (slot->entry)
+			{
+				slot->entry->first = key;
+				slot->entry->second = value;
+			}
+			else
+				slot->entry.emplace(key, value);
+			return true;
 		}
 
 		virtual void Remove(const Key& key) override
 		{
 			size_t slice_index = _Hash(key) % m_sliceNum;
-			return m_sliceCaches[slice_index]->Remove(key);
+			if (!_Replicating())
+			{
+				m_sliceCaches[slice_index]->Remove(key);
+				_BumpEpoch(slice_index);
+				return;
+			}
+
+			std::shared_lock<std::shared_mutex> shared(m_hotMutex);
+			if (m_hotKeys.find(key) == m_hotKeys.end())
+			{
+				m_sliceCaches[slice_index]->Remove(key);
+				_BumpEpoch(slice_index);
+				return;
+			}
+			shared.unlock();
+
+			std::unique_lock<std::shared_mutex> exclusive(m_hotMutex);
+			m_sliceCaches[slice_index]->Remove(key);
+			if (m_hotKeys.find(key) != m_hotKeys.end())
+				_RemoveReplicas(key, slice_index);
+			_BumpEpoch(slice_index);
 		}
 
 		virtual size_t Size() const override
@@ -221,17 +446,299 @@ namespace CacheCpp {
 
 		virtual size_t Capacity() const override { return m_capacity; }
 
+		virtual void SetEvictionCallback(typename ICachePolicy<Key, Value>::EvictionCallback callback) override
+		{
+			// replicas of hot keys are copies, dropping one of them is not an eviction
+			for (auto& slice : m_sliceCaches)
+				slice->SetEvictionCallback(callback);
+		}
+
+		// Summed over slices, all zero unless filterCountersPerKey is set.
+		NegativeFilterStats FilterStats() const
+		{
+			NegativeFilterStats stats;
+			for (const auto& filter : m_filters)
+			{
+				stats.rejected += filter->rejected.load(std::memory_order_relaxed);
+				stats.falsePositives += filter->falsePositives.load(std::memory_order_relaxed);
+			}
+			return stats;
+		}
+
+		// Heaviest sampled keys so far, empty unless hotKeySampleRate is set.
+		std::vector<HeavyHitter<Key>> HotKeys(size_t k) const
+		{
+			if (!m_tracker)
+				return {};
+			return m_tracker->TopK(k);
+		}
+
 	private:
+		struct alignas(64) SliceEpoch
+		{
+			std::atomic<uint64_t> value{ 0 };
+		};
+
+		struct FrontSlot
+		{
+			uint64_t epoch = 0;
+			uint32_t hits = 0;
+			std::optional<std::pair<Key, Value>> entry;   // empty until first filled, so Key/Value need no default
+		};
+
+		using FrontCache = std::array<FrontSlot, FRONT_CACHE_SLOTS>;
+
+		struct alignas(64) SliceFilter
+		{
+			SliceFilter(size_t expectedKeys, int countersPerKey)
+				: filter(expectedKeys, countersPerKey), rejected(0), falsePositives(0)
+			{
+			}
+
+			CountingBloomFilter filter;
+			std::atomic<size_t> rejected;
+			std::atomic<size_t> falsePositives;
+		};
+
 		size_t _Hash(const Key& key)
 		{
 			std::hash<Key> hash_func;
 			return hash_func(key);
 		}
 
+		void _BumpEpoch(size_t sliceIndex)
+		{
+			if (m_frontCache)
+				m_epochs[sliceIndex].value.fetch_add(1, std::memory_order_release);
+		}
+
+		bool _Replicating() const { return m_tracker && m_replicas > 1; }
+
+		bool _GetFromSlices(const Key& key, size_t hash, size_t sliceIndex, Value& value)
+		{
+			if (m_filters.empty())
+				return _GetFromSlicesLocked(key, hash, sliceIndex, value);
+
+			// the primary copy is authoritative, so its filter alone decides whether any copy is worth a lock
+			SliceFilter& filter = *m_filters[sliceIndex];
+			if (!filter.filter.MayContain(hash))
+			{
+				filter.rejected.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			if (_GetFromSlicesLocked(key, hash, sliceIndex, value))
+				return true;
+			filter.falsePositives.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		bool _GetFromSlicesLocked(const Key& key, size_t hash, size_t sliceIndex, Value& value)
+		{
+			if (_Replicating() && _MaybeHot(hash))
+			{
+				size_t offset = _ThreadIndex() % m_replicas;
+				if (offset != 0 && m_replicaCaches[(sliceIndex + offset) % m_sliceNum]->Get(key, value))
+				{
+					_RefreshPrimary(key, sliceIndex);
+					return true;
+				}
+			}
+			return m_sliceCaches[sliceIndex]->Get(key, value);
+		}
+
+		// Reads the primary copy on every REPLICA_REFRESH-th replica hit of this thread, so keys served mostly
+		// from replicas are not aged out of their own slice. If the primary is gone it was evicted, and the
+		// copies follow; racing with a hot write can at worst drop fresh copies, which only costs a fallback.
+		void _RefreshPrimary(const Key& key, size_t sliceIndex)
+		{
+			static thread_local uint32_t replica_hits = 0;
+			if (++replica_hits % REPLICA_REFRESH != 0)
+				return;
+
+			Value primary{};
+			if (m_sliceCaches[sliceIndex]->Get(key, primary))
+				return;
+			for (int i = 1; i < m_replicas; ++i)
+				m_replicaCaches[(sliceIndex + i) % m_sliceNum]->Remove(key);
+		}
+
+		// Lock-free view of the hot set for readers; false positives and misses only cost a fallback
+		// to the primary slice, so it is rebuilt in place without coordinating with them.
+		bool _MaybeHot(size_t hash) const
+		{
+			size_t tag = hash ? hash : 1;
+			for (size_t i = 0; i < HOT_TABLE_SLOTS; ++i)
+			{
+				size_t slot = m_hotHashes[(hash + i) % HOT_TABLE_SLOTS].load(std::memory_order_relaxed);
+				if (slot == 0)
+					return false;
+				if (slot == tag)
+					return true;
+			}
+			return false;
+		}
+
+		void _SampleHotKey(const Key& key)
+		{
+			static thread_local uint32_t sample_counter = 0;
+			if (++sample_counter % m_sampleRate != 0)
+				return;
+
+			m_tracker->Offer(key);
+			if (m_samples.fetch_add(1, std::memory_order_relaxed) % HOT_REFRESH_INTERVAL == HOT_REFRESH_INTERVAL - 1)
+				_RefreshHotKeys();
+		}
+
+		void _RefreshHotKeys()
+		{
+			std::unique_lock<std::shared_mutex> lock(m_hotMutex, std::try_to_lock);
+			if (!lock.owns_lock())
+				return;
+
+			if (_Replicating())
+			{
+				size_t threshold = static_cast<size_t>(m_tracker->Total() * m_hotKeyMinShare);
+				std::unordered_set<Key> hot_keys;
+				for (const auto& hitter : m_tracker->TopK(m_maxHotKeys))
+				{
+					if (hitter.count - hitter.error >= threshold)
+						hot_keys.insert(hitter.key);
+				}
+
+				for (const Key& key : m_hotKeys)
+				{
+					if (hot_keys.find(key) == hot_keys.end())
+						_RemoveReplicas(key, _Hash(key) % m_sliceNum);
+				}
+				for (const Key& key : hot_keys)
+				{
+					if (m_hotKeys.find(key) == m_hotKeys.end())
+						_CopyToReplicas(key, _Hash(key) % m_sliceNum);
+				}
+				m_hotKeys.swap(hot_keys);
+				_PublishHotKeys();
+			}
+
+			m_tracker->Decay();
+		}
+
+		// caller holds m_hotMutex exclusively
+		void _PublishHotKeys()
+		{
+			for (auto& slot : m_hotHashes)
+				slot.store(0, std::memory_order_relaxed);
+			for (const Key& key : m_hotKeys)
+			{
+				size_t hash = _Hash(key);
+				for (size_t i = 0; i < HOT_TABLE_SLOTS; ++i)
+				{
+					auto& slot = m_hotHashes[(hash + i) % HOT_TABLE_SLOTS];
+					if (slot.load(std::memory_order_relaxed) == 0)
+					{
+						slot.store(hash ? hash : 1, std::memory_order_relaxed);
+						break;
+					}
+				}
+			}
+		}
+
+		// caller holds m_hotMutex exclusively
+		void _CopyToReplicas(const Key& key, size_t sliceIndex)
+		{
+			Value value{};
+			if (!m_sliceCaches[sliceIndex]->Peek(key, value))
+				return;
+
+			for (int i = 1; i < m_replicas; ++i)
+				m_replicaCaches[(sliceIndex + i) % m_sliceNum]->Put(key, value);
+		}
+
+		// caller holds m_hotMutex exclusively
+		void _RemoveReplicas(const Key& key, size_t sliceIndex)
+		{
+			for (int i = 1; i < m_replicas; ++i)
+				m_replicaCaches[(sliceIndex + i) % m_sliceNum]->Remove(key);
+		}
+
+		// This thread's table in this cache, allocated on its first read so threads that never read pay nothing.
+		// Only the thread holding an index touches its table, and a thread's index is only handed out again
+		// after it exited, so the slots need no synchronisation. nullptr past FRONT_CACHE_THREADS live threads.
+		FrontSlot* _GetFrontSlot(size_t hash)
+		{
+			size_t thread = _ThreadIndex();
+			if (thread >= m_frontCaches.size())
+				return nullptr;
+			std::unique_ptr<FrontCache>& front_cache = m_frontCaches[thread];
+			if (!front_cache)
+				front_cache = std::make_unique<FrontCache>();
+			return &(*front_cache)[(hash >> 8 ^ hash) % FRONT_CACHE_SLOTS];
+		}
+
+		// Dense per-thread index; an exiting thread returns its index, so indices stay below the number of
+		// threads alive at once. The pool is never freed, threads may still exit after static destruction.
+		struct ThreadIndexPool
+		{
+			std::mutex mutex;
+			std::vector<size_t> free;
+			size_t next = 0;
+		};
+
+		struct ThreadIndex
+		{
+			ThreadIndex()
+			{
+				ThreadIndexPool& pool = _ThreadIndexPool();
+				std::lock_guard<std::mutex> lock(pool.mutex);
+				if (pool.free.empty())
+					value = pool.next++;
+				else
+				{
+					value = pool.free.back();
+					pool.free.pop_back();
+				}
+			}
+
+			~ThreadIndex()
+			{
+				ThreadIndexPool& pool = _ThreadIndexPool();
+				std::lock_guard<std::mutex> lock(pool.mutex);
+				pool.free.push_back(value);
+			}
+
+			size_t value;
+		};
+
+		static ThreadIndexPool& _ThreadIndexPool()
+		{
+			static ThreadIndexPool* pool = new ThreadIndexPool();
+			return *pool;
+		}
+
+		static size_t _ThreadIndex()
+		{
+			static thread_local ThreadIndex index;
+			return index.value;
+		}
+
 	private:
 		int m_capacity;
 		int m_sliceNum;
-		std::vector<std::unique_ptr<LRUCache<Key, Value>>> m_sliceCaches;
+		bool m_frontCache;
+		std::vector<SliceEpoch> m_epochs;
+		std::vector<std::unique_ptr<FrontCache>> m_frontCaches;     // per thread index, empty unless frontCache
+		std::vector<std::unique_ptr<LRUCacheFor<Key, Value>>> m_sliceCaches;
+		std::vector<std::unique_ptr<LRUCacheFor<Key, Value>>> m_replicaCaches;   // per slice, empty unless replicating
+		std::vector<std::unique_ptr<SliceFilter>> m_filters;        // one per slice, empty when disabled
+
+		int m_sampleRate;
+		int m_replicas;
+		int m_maxHotKeys;
+		double m_hotKeyMinShare;
+		std::atomic<size_t> m_samples;
+		std::unique_ptr<SpaceSaving<Key>> m_tracker;
+		std::shared_mutex m_hotMutex;                               // shared: cold writes, exclusive: hot writes and refresh
+		std::unordered_set<Key> m_hotKeys;                          // exact hot set, guarded by m_hotMutex
+		std::array<std::atomic<size_t>, HOT_TABLE_SLOTS> m_hotHashes;   // reader-side view of m_hotKeys
 	};
 
 }
\ No newline at end of file
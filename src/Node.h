@@ -1,18 +1,37 @@
 #pragma once
 
+#include <memory>
+#include <type_traits>
+#include <utility>
+
 namespace CacheCpp{
+	// Assigns straight from a single Value argument, otherwise builds the Value from args and moves it in.
+	template<typename Value, typename... Args>
+	void AssignValue(Value& target, Args&&... args)
+	{
+		if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, Value> && ...))
+			target = (std::forward<Args>(args), ...);
+		else
+			target = Value(std::forward<Args>(args)...);
+	}
+
 	template<typename Key, typename Value>
 	class Node
 	{
 	public:
-		Node(const Key key, const Value value)
-			:m_key(std::move(key)), m_value(std::move(value)), m_accessCount(1),
+		// args are forwarded to Value's constructor, so the value is built directly inside the node
+		template<typename... Args>
+		explicit Node(const Key& key, Args&&... args)
+			:m_key(key), m_value(std::forward<Args>(args)...), m_accessCount(1),
 			m_next(nullptr)
 		{
 		}
 		~Node() = default;
 
 		void SetValue(const Value& value) { m_value = value; }
+		void SetValue(Value&& value) { m_value = std::move(value); }
+		template<typename... Args>
+		void EmplaceValue(Args&&... args) { AssignValue(m_value, std::forward<Args>(args)...); }
 		const Key& GetKey() const { return m_key; }
 		const Value& GetValue() const { return m_value; }
 		const size_t GetAccessCount() const { return m_accessCount; }
@@ -85,8 +104,8 @@ namespace CacheCpp{
 	private:
 		void _InitialiseList()
 		{
-			m_head = std::make_shared<NodeType>(Key(), Value());
-			m_tail = std::make_shared<NodeType>(Key(), Value());
+			m_head = std::make_shared<NodeType>(Key());
+			m_tail = std::make_shared<NodeType>(Key());
 			m_head->SetNext(m_tail);
 			m_tail->SetPrev(m_head);
 		}
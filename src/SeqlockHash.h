@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "CachePolicy.h"
+#include "EpochReclaim.h"
+
+namespace CacheCpp {
+
+	// Sharded cache whose Get takes no lock.
+	// Each slice is a fixed-size chained hash index plus a CLOCK ring for eviction. Writers are serialised by
+	// the slice mutex and never modify a published entry: an update links a new entry in place of the old one.
+	// Every group of buckets carries a sequence counter that writers make odd while they relink a chain;
+	// readers walk the chain optimistically and retry only if that counter moved underneath them.
+	// Unlinked entries are handed to EpochDomain, so a reader still walking one never sees it freed.
+	// Recency is approximate: a hit only sets the entry's reference bit, which the CLOCK hand clears, because
+	// moving the entry on an LRU list would put a write (and a lock) back on the read path.
+	template<typename Key, typename Value>
+	class SeqlockHashCache : public ICachePolicy<Key, Value>
+	{
+	public:
+		static constexpr size_t BUCKETS_PER_GROUP = 16;   // buckets sharing one sequence counter
+
+		SeqlockHashCache(int capacity, int sliceNum = 0)
+			: m_capacity(capacity),
+			m_sliceNum(sliceNum > 0 ? sliceNum : std::max(1u, std::thread::hardware_concurrency()))
+		{
+			size_t slice_size = capacity > 0 ? (capacity + m_sliceNum - 1) / m_sliceNum : 0;
+			for (int i = 0; i < m_sliceNum; ++i)
+			{
+				m_slices.emplace_back(std::make_unique<Slice>(slice_size));
+			}
+		}
+
+		virtual ~SeqlockHashCache() override
+		{
+			// no reader can be inside the cache any more; entries already retired belong to the domain
+			for (auto& slice : m_slices)
+			{
+				for (Entry* entry : slice->ring)
+					delete entry;
+			}
+		}
+
+		SeqlockHashCache(const SeqlockHashCache&) = delete;
+		SeqlockHashCache& operator=(const SeqlockHashCache&) = delete;
+
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
+		{
+			if (m_capacity <= 0)
+				return;
+
+			size_t hash = _Hash(key);
+			Slice& slice = *m_slices[hash % m_sliceNum];
+			size_t bucket = _Bucket(slice, hash);
+			Entry* fresh = new Entry(key, hash, std::forward<Args>(args)...);
+
+			std::lock_guard<std::mutex> lock(slice.mutex);
+			std::atomic<Entry*>* link = _FindLink(slice, bucket, key);
+			Entry* old = link->load(std::memory_order_relaxed);
+			if (old)
+			{
+				// an update counts as a reference and takes over the old entry's clock slot
+				fresh->slot = old->slot;
+				fresh->referenced.store(true, std::memory_order_relaxed);
+				fresh->next.store(old->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				_BeginWrite(slice, bucket);
+				link->store(fresh, std::memory_order_release);
+				_EndWrite(slice, bucket);
+				slice.ring[fresh->slot] = fresh;
+				EpochDomain::Global().Retire(old);
+				return;
+			}
+
+			if (slice.free.empty())
+				_EvictEntry(slice);
+
+			fresh->slot = slice.free.back();
+			slice.free.pop_back();
+			slice.ring[fresh->slot] = fresh;
+			fresh->next.store(slice.buckets[bucket].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			_BeginWrite(slice, bucket);
+			slice.buckets[bucket].store(fresh, std::memory_order_release);
+			_EndWrite(slice, bucket);
+			slice.size.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		bool Get(const Key& key, Value& value) override
+		{
+			size_t hash = _Hash(key);
+			Slice& slice = *m_slices[hash % m_sliceNum];
+			size_t bucket = _Bucket(slice, hash);
+			const std::atomic<uint64_t>& sequence = slice.groups[bucket / BUCKETS_PER_GROUP].sequence;
+
+			EpochDomain::Guard guard;
+			Entry* found = nullptr;
+			while (true)
+			{
+				uint64_t before = sequence.load(std::memory_order_acquire);
+				if (before & 1)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				found = nullptr;
+				for (Entry* entry = slice.buckets[bucket].load(std::memory_order_acquire); entry;
+					entry = entry->next.load(std::memory_order_acquire))
+				{
+					if (entry->hash == hash && entry->key == key)
+					{
+						found = entry;
+						break;
+					}
+				}
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (sequence.load(std::memory_order_relaxed) == before)
+					break;
+			}
+
+			if (!found)
+				return false;
+
+			// entries are immutable once published and the guard keeps this one alive
+			value = found->value;
+			if (!found->referenced.load(std::memory_order_relaxed))
+				found->referenced.store(true, std::memory_order_relaxed);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			size_t hash = _Hash(key);
+			Slice& slice = *m_slices[hash % m_sliceNum];
+			size_t bucket = _Bucket(slice, hash);
+
+			std::lock_guard<std::mutex> lock(slice.mutex);
+			std::atomic<Entry*>* link = _FindLink(slice, bucket, key);
+			Entry* entry = link->load(std::memory_order_relaxed);
+			if (!entry)
+				return;
+
+			_Unlink(slice, bucket, link, entry);
+			EpochDomain::Global().Retire(entry);
+		}
+
+		virtual size_t Size() const override
+		{
+			size_t size = 0;
+			for (const auto& slice : m_slices)
+				size += slice->size.load(std::memory_order_relaxed);
+			return size;
+		}
+
+		virtual size_t Capacity() const override { return m_capacity; }
+
+	private:
+		struct Entry
+		{
+			template<typename... Args>
+			Entry(const Key& key, size_t hash, Args&&... args)
+				: key(key), value(std::forward<Args>(args)...), hash(hash), slot(0), next(nullptr), referenced(false)
+			{
+			}
+
+			const Key key;
+			const Value value;
+			const size_t hash;
+			uint32_t slot;                    // position in the slice's clock ring, writer-only
+			std::atomic<Entry*> next;
+			std::atomic<bool> referenced;     // CLOCK bit, set by readers
+		};
+
+		struct alignas(64) BucketGroup
+		{
+			std::atomic<uint64_t> sequence{ 0 };   // odd while a writer relinks one of the group's chains
+		};
+
+		struct Slice
+		{
+			explicit Slice(size_t capacity)
+				: bucketMask(_BucketCount(capacity) - 1),
+				buckets(bucketMask + 1),
+				groups((bucketMask + 1 + BUCKETS_PER_GROUP - 1) / BUCKETS_PER_GROUP),
+				ring(capacity, nullptr), hand(0), size(0)
+			{
+				for (auto& bucket : buckets)
+					bucket.store(nullptr, std::memory_order_relaxed);
+				free.reserve(capacity);
+				for (size_t slot = capacity; slot-- > 0; )
+					free.push_back(static_cast<uint32_t>(slot));
+			}
+
+			// load factor stays at or below one; the index never grows because the capacity is fixed
+			static size_t _BucketCount(size_t capacity)
+			{
+				size_t count = 1;
+				while (count < capacity)
+					count <<= 1;
+				return count;
+			}
+
+			size_t bucketMask;
+			std::vector<std::atomic<Entry*>> buckets;
+			std::vector<BucketGroup> groups;
+
+			std::mutex mutex;                 // serialises writers; readers never take it
+			std::vector<Entry*> ring;         // CLOCK order, nullptr = free slot
+			std::vector<uint32_t> free;       // free ring slots
+			size_t hand;
+			std::atomic<size_t> size;
+		};
+
+		static size_t _Hash(const Key& key)
+		{
+			// std::hash is the identity for integers; spread the bits before taking slice and bucket from them
+			uint64_t x = static_cast<uint64_t>(std::hash<Key>{}(key));
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			return static_cast<size_t>(x ^ (x >> 31));
+		}
+
+		size_t _Bucket(const Slice& slice, size_t hash) const
+		{
+			return (hash / m_sliceNum) & slice.bucketMask;
+		}
+
+		// caller holds slice.mutex; returns the link that points at key's entry, or the chain's null tail
+		static std::atomic<Entry*>* _FindLink(Slice& slice, size_t bucket, const Key& key)
+		{
+			std::atomic<Entry*>* link = &slice.buckets[bucket];
+			for (Entry* entry = link->load(std::memory_order_relaxed); entry;
+				entry = link->load(std::memory_order_relaxed))
+			{
+				if (entry->key == key)
+					break;
+				link = &entry->next;
+			}
+			return link;
+		}
+
+		// caller holds slice.mutex
+		void _EvictEntry(Slice& slice)
+		{
+			// each full sweep clears every reference bit, so this ends within two laps
+			while (true)
+			{
+				Entry* entry = slice.ring[slice.hand];
+				slice.hand = (slice.hand + 1) % slice.ring.size();
+				if (!entry)
+					continue;
+				if (entry->referenced.load(std::memory_order_relaxed))
+				{
+					entry->referenced.store(false, std::memory_order_relaxed);
+					continue;
+				}
+
+				size_t bucket = _Bucket(slice, entry->hash);
+				std::atomic<Entry*>* link = _FindLink(slice, bucket, entry->key);
+				_Unlink(slice, bucket, link, entry);
+				this->_NotifyEvicted(entry->key, entry->value);
+				EpochDomain::Global().Retire(entry);
+				return;
+			}
+		}
+
+		// caller holds slice.mutex
+		void _Unlink(Slice& slice, size_t bucket, std::atomic<Entry*>* link, Entry* entry)
+		{
+			// entry->next is left intact so a reader standing on entry can still finish the chain
+			_BeginWrite(slice, bucket);
+			link->store(entry->next.load(std::memory_order_relaxed), std::memory_order_release);
+			_EndWrite(slice, bucket);
+
+			slice.ring[entry->slot] = nullptr;
+			slice.free.push_back(entry->slot);
+			slice.size.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		static void _BeginWrite(Slice& slice, size_t bucket)
+		{
+			auto& sequence = slice.groups[bucket / BUCKETS_PER_GROUP].sequence;
+			sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+		}
+
+		static void _EndWrite(Slice& slice, size_t bucket)
+		{
+			auto& sequence = slice.groups[bucket / BUCKETS_PER_GROUP].sequence;
+			sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+	private:
+		int m_capacity;
+		int m_sliceNum;
+		std::vector<std::unique_ptr<Slice>> m_slices;
+	};
+}
@@ -0,0 +1,482 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CACHECPP_HAS_SHARED_MEMORY 1
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	enum class SharedMemoryBacking
+	{
+		PosixShm,   // name is a shm_open() name such as "/my_cache"
+		File,       // name is a file path, e.g. on tmpfs or a DAX mount
+	};
+
+	// Sharded LRU cache living entirely inside one shared mapping, so every local process can attach to it.
+	// The segment holds a header, then per shard: a control block with a process-shared mutex, the bucket
+	// heads and a fixed node array. Links are 32-bit node indices rather than pointers, because each
+	// process maps the segment at a different address. Key and Value are copied bitwise into the segment,
+	// hence must be trivially copyable, and std::hash<Key> must agree across the attached processes
+	// (true for the same binary).
+	template<typename Key, typename Value>
+	class SharedMemoryCache : public ICachePolicy<Key, Value>
+	{
+		static_assert(std::is_trivially_copyable<Key>::value, "SharedMemoryCache keys are copied bitwise");
+		static_assert(std::is_trivially_copyable<Value>::value, "SharedMemoryCache values are copied bitwise");
+
+	public:
+		// Creates the segment if it does not exist yet, otherwise attaches to it.
+		// Attaching with a different geometry, or to a segment of another Key/Value layout, throws; so does
+		// attaching to a segment whose creator has not finished setting it up within ATTACH_TIMEOUT.
+		SharedMemoryCache(const std::string& name, int capacity, int shardNum,
+			SharedMemoryBacking backing = SharedMemoryBacking::PosixShm)
+			: m_base(nullptr), m_segmentSize(0)
+		{
+			Geometry geometry = _ComputeGeometry(capacity, shardNum > 0 ? shardNum : 1);
+			m_segmentSize = geometry.segmentSize;
+
+			bool creator = false;
+			int fd = _Open(name, backing, creator);
+			if (creator && ftruncate(fd, static_cast<off_t>(m_segmentSize)) != 0)
+			{
+				int err = errno;
+				close(fd);
+				throw std::runtime_error("SharedMemoryCache: ftruncate failed: " + std::string(std::strerror(err)));
+			}
+			if (!creator && !_WaitForSize(fd))
+			{
+				close(fd);
+				throw std::runtime_error("SharedMemoryCache: segment '" + name + "' was never sized; its creator "
+					"probably died, Unlink() it and retry");
+			}
+
+			void* mem = mmap(nullptr, m_segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close(fd);
+			if (mem == MAP_FAILED)
+				throw std::runtime_error("SharedMemoryCache: mmap failed: " + std::string(std::strerror(errno)));
+			m_base = static_cast<char*>(mem);
+
+			if (creator)
+			{
+				_Initialise(geometry);
+			}
+			else
+			{
+				if (!_WaitForInitialised())
+				{
+					munmap(m_base, m_segmentSize);
+					throw std::runtime_error("SharedMemoryCache: segment '" + name + "' was never initialised; its "
+						"creator probably died, Unlink() it and retry");
+				}
+				if (_GetHeader()->magic != MAGIC
+					|| std::memcmp(&_GetHeader()->geometry, &geometry, sizeof(Geometry)) != 0)
+				{
+					munmap(m_base, m_segmentSize);
+					throw std::runtime_error("SharedMemoryCache: segment '" + name + "' has a different layout");
+				}
+			}
+		}
+
+		virtual ~SharedMemoryCache() override
+		{
+			if (m_base)
+				munmap(m_base, m_segmentSize);
+		}
+
+		SharedMemoryCache(const SharedMemoryCache&) = delete;
+		SharedMemoryCache& operator=(const SharedMemoryCache&) = delete;
+
+		// The segment outlives every process attached to it until it is unlinked.
+		static void Unlink(const std::string& name, SharedMemoryBacking backing = SharedMemoryBacking::PosixShm)
+		{
+			if (backing == SharedMemoryBacking::PosixShm)
+				shm_unlink(name.c_str());
+			else
+				unlink(name.c_str());
+		}
+
+		void Put(const Key& key, const Value& value) override
+		{
+			if (_GetHeader()->geometry.capacity == 0)
+				return;
+
+			size_t hash = _Hash(key);
+			ShardLock lock(*this, hash % _GetHeader()->geometry.shardNum);
+			Shard& shard = lock.shard;
+			uint32_t index = _Find(shard, hash, key);
+			if (index != NIL)
+			{
+				_GetNode(shard, index).value = value;
+				_MoveToMostRecent(shard, index);
+				return;
+			}
+
+			if (shard.freeHead == NIL)
+				_EvictNode(shard);
+
+			index = shard.freeHead;
+			SlotNode& node = _GetNode(shard, index);
+			shard.freeHead = node.next;
+
+			node.key = key;
+			node.value = value;
+			uint32_t& bucket = _GetBucket(shard, hash);
+			node.hashNext = bucket;
+			bucket = index;
+			_LinkAtHead(shard, index);
+			++shard.size;
+		}
+
+		void Put(const Key& key, Value&& value) override { Put(key, static_cast<const Value&>(value)); }
+
+		bool Get(const Key& key, Value& value) override
+		{
+			size_t hash = _Hash(key);
+			ShardLock lock(*this, hash % _GetHeader()->geometry.shardNum);
+			uint32_t index = _Find(lock.shard, hash, key);
+			if (index == NIL)
+				return false;
+
+			value = _GetNode(lock.shard, index).value;
+			_MoveToMostRecent(lock.shard, index);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			size_t hash = _Hash(key);
+			ShardLock lock(*this, hash % _GetHeader()->geometry.shardNum);
+			uint32_t index = _Find(lock.shard, hash, key);
+			if (index != NIL)
+				_FreeNode(lock.shard, hash, index);
+		}
+
+		virtual size_t Size() const override
+		{
+			size_t size = 0;
+			for (uint32_t i = 0; i < _GetHeader()->geometry.shardNum; ++i)
+			{
+				ShardLock lock(*this, i);
+				size += lock.shard.size;
+			}
+			return size;
+		}
+
+		virtual size_t Capacity() const override { return _GetHeader()->geometry.capacity; }
+
+		size_t SegmentSize() const { return m_segmentSize; }
+
+	private:
+		static constexpr uint32_t NIL = UINT32_MAX;
+		static constexpr uint64_t MAGIC = 0x43616368654370ULL;   // "CacheCp"
+		static constexpr size_t ALIGNMENT = 64;
+		// how long an attacher waits for the creator to size and initialise the segment
+		static constexpr std::chrono::milliseconds ATTACH_TIMEOUT{ 5000 };
+
+		struct Geometry
+		{
+			uint64_t keySize;
+			uint64_t valueSize;
+			uint64_t capacity;
+			uint64_t shardNum;
+			uint64_t nodesPerShard;
+			uint64_t bucketsPerShard;     // power of two
+			uint64_t shardStride;         // bytes from one shard to the next
+			uint64_t bucketsOffset;       // within a shard
+			uint64_t nodesOffset;         // within a shard
+			uint64_t segmentSize;
+		};
+
+		struct Header
+		{
+			uint64_t magic;
+			std::atomic<uint32_t> initialised;
+			Geometry geometry;
+		};
+
+		struct Shard
+		{
+			pthread_mutex_t mutex;
+			uint32_t lruHead;    // most recent
+			uint32_t lruTail;    // next victim
+			uint32_t freeHead;   // free nodes chained through SlotNode::next
+			uint32_t size;
+		};
+
+		struct SlotNode
+		{
+			Key key;
+			Value value;
+			uint32_t prev;
+			uint32_t next;
+			uint32_t hashNext;
+		};
+
+		static_assert(std::atomic<uint32_t>::is_always_lock_free, "header flag must be address-free across processes");
+
+		class ShardLock
+		{
+		public:
+			ShardLock(const SharedMemoryCache& cache, size_t shardIndex)
+				: shard(cache._GetShard(shardIndex)), m_cache(cache)
+			{
+				int rc = pthread_mutex_lock(&shard.mutex);
+#if defined(__linux__)
+				if (rc == EOWNERDEAD)
+				{
+					// the previous owner died mid-update; a cache may drop data, so start the shard over
+					m_cache._ResetShard(shard);
+					rc = pthread_mutex_consistent(&shard.mutex);
+					if (rc != 0)
+						pthread_mutex_unlock(&shard.mutex);
+				}
+#endif
+				// the lock is not held here, so the shard must not be touched
+				if (rc != 0)
+					throw std::runtime_error("SharedMemoryCache: cannot lock shard: " + std::string(std::strerror(rc)));
+			}
+
+			~ShardLock() { pthread_mutex_unlock(&shard.mutex); }
+
+			Shard& shard;
+
+		private:
+			const SharedMemoryCache& m_cache;
+		};
+
+		static size_t _AlignUp(size_t value) { return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+		static Geometry _ComputeGeometry(int capacity, int shardNum)
+		{
+			Geometry geometry{};
+			geometry.keySize = sizeof(Key);
+			geometry.valueSize = sizeof(Value);
+			geometry.capacity = capacity > 0 ? capacity : 0;
+			geometry.shardNum = shardNum;
+			geometry.nodesPerShard = (geometry.capacity + shardNum - 1) / shardNum;
+			if (geometry.nodesPerShard == 0)
+				geometry.nodesPerShard = 1;
+
+			geometry.bucketsPerShard = 1;
+			while (geometry.bucketsPerShard < geometry.nodesPerShard)
+				geometry.bucketsPerShard <<= 1;
+
+			geometry.bucketsOffset = _AlignUp(sizeof(Shard));
+			geometry.nodesOffset = _AlignUp(geometry.bucketsOffset + geometry.bucketsPerShard * sizeof(uint32_t));
+			geometry.shardStride = _AlignUp(geometry.nodesOffset + geometry.nodesPerShard * sizeof(SlotNode));
+			geometry.segmentSize = _AlignUp(sizeof(Header)) + geometry.shardStride * shardNum;
+			return geometry;
+		}
+
+		static int _Open(const std::string& name, SharedMemoryBacking backing, bool& creator)
+		{
+			auto open_segment = [&](int flags) {
+				return backing == SharedMemoryBacking::PosixShm
+					? shm_open(name.c_str(), flags, 0600)
+					: open(name.c_str(), flags, 0600);
+			};
+
+			int fd = open_segment(O_RDWR | O_CREAT | O_EXCL);
+			creator = fd >= 0;
+			if (fd < 0 && errno == EEXIST)
+				fd = open_segment(O_RDWR);
+			if (fd < 0)
+				throw std::runtime_error("SharedMemoryCache: cannot open '" + name + "': " + std::strerror(errno));
+			return fd;
+		}
+
+		// the creator sizes the segment right after creating it; attachers must not map it before that
+		bool _WaitForSize(int fd) const
+		{
+			auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+			struct stat st;
+			while (true)
+			{
+				if (fstat(fd, &st) != 0)
+					return false;
+				if (static_cast<size_t>(st.st_size) >= m_segmentSize)
+					return true;
+				if (std::chrono::steady_clock::now() >= deadline)
+					return false;
+				std::this_thread::yield();
+			}
+		}
+
+		// false if the creator died (or stalled) before publishing the segment
+		bool _WaitForInitialised() const
+		{
+			auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+			while (_GetHeader()->initialised.load(std::memory_order_acquire) == 0)
+			{
+				if (std::chrono::steady_clock::now() >= deadline)
+					return false;
+				std::this_thread::yield();
+			}
+			return true;
+		}
+
+		void _Initialise(const Geometry& geometry)
+		{
+			Header* header = _GetHeader();
+			header->magic = MAGIC;
+			header->geometry = geometry;
+
+			pthread_mutexattr_t attr;
+			pthread_mutexattr_init(&attr);
+			pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#if defined(__linux__)
+			pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+#endif
+			for (uint32_t i = 0; i < geometry.shardNum; ++i)
+			{
+				Shard& shard = _GetShard(i);
+				pthread_mutex_init(&shard.mutex, &attr);
+				_ResetShard(shard);
+			}
+			pthread_mutexattr_destroy(&attr);
+
+			header->initialised.store(1, std::memory_order_release);
+		}
+
+		void _ResetShard(Shard& shard) const
+		{
+			const Geometry& geometry = _GetHeader()->geometry;
+			shard.lruHead = NIL;
+			shard.lruTail = NIL;
+			shard.size = 0;
+			for (uint64_t b = 0; b < geometry.bucketsPerShard; ++b)
+				_GetBucketAt(shard, b) = NIL;
+
+			shard.freeHead = NIL;
+			for (uint64_t n = geometry.nodesPerShard; n-- > 0; )
+			{
+				_GetNode(shard, static_cast<uint32_t>(n)).next = shard.freeHead;
+				shard.freeHead = static_cast<uint32_t>(n);
+			}
+		}
+
+		Header* _GetHeader() const { return reinterpret_cast<Header*>(m_base); }
+
+		Shard& _GetShard(size_t index) const
+		{
+			const Geometry& geometry = _GetHeader()->geometry;
+			return *reinterpret_cast<Shard*>(m_base + _AlignUp(sizeof(Header)) + index * geometry.shardStride);
+		}
+
+		uint32_t& _GetBucketAt(Shard& shard, uint64_t bucket) const
+		{
+			char* buckets = reinterpret_cast<char*>(&shard) + _GetHeader()->geometry.bucketsOffset;
+			return reinterpret_cast<uint32_t*>(buckets)[bucket];
+		}
+
+		uint32_t& _GetBucket(Shard& shard, size_t hash) const
+		{
+			const Geometry& geometry = _GetHeader()->geometry;
+			// the low bits already picked the shard
+			return _GetBucketAt(shard, (hash / geometry.shardNum) & (geometry.bucketsPerShard - 1));
+		}
+
+		SlotNode& _GetNode(Shard& shard, uint32_t index) const
+		{
+			char* nodes = reinterpret_cast<char*>(&shard) + _GetHeader()->geometry.nodesOffset;
+			return reinterpret_cast<SlotNode*>(nodes)[index];
+		}
+
+		size_t _Hash(const Key& key) const
+		{
+			std::hash<Key> hash_func;
+			return hash_func(key);
+		}
+
+		uint32_t _Find(Shard& shard, size_t hash, const Key& key) const
+		{
+			for (uint32_t index = _GetBucket(shard, hash); index != NIL; index = _GetNode(shard, index).hashNext)
+			{
+				if (_GetNode(shard, index).key == key)
+					return index;
+			}
+			return NIL;
+		}
+
+		void _LinkAtHead(Shard& shard, uint32_t index)
+		{
+			SlotNode& node = _GetNode(shard, index);
+			node.prev = NIL;
+			node.next = shard.lruHead;
+			if (shard.lruHead != NIL)
+				_GetNode(shard, shard.lruHead).prev = index;
+			shard.lruHead = index;
+			if (shard.lruTail == NIL)
+				shard.lruTail = index;
+		}
+
+		void _Unlink(Shard& shard, uint32_t index)
+		{
+			SlotNode& node = _GetNode(shard, index);
+			if (node.prev != NIL)
+				_GetNode(shard, node.prev).next = node.next;
+			else
+				shard.lruHead = node.next;
+			if (node.next != NIL)
+				_GetNode(shard, node.next).prev = node.prev;
+			else
+				shard.lruTail = node.prev;
+		}
+
+		void _MoveToMostRecent(Shard& shard, uint32_t index)
+		{
+			if (shard.lruHead == index)
+				return;
+			_Unlink(shard, index);
+			_LinkAtHead(shard, index);
+		}
+
+		void _EvictNode(Shard& shard)
+		{
+			uint32_t victim = shard.lruTail;
+			if (victim == NIL)
+				return;
+			SlotNode& node = _GetNode(shard, victim);
+			_FreeNode(shard, _Hash(node.key), victim);
+			// only the process that caused the eviction hears about it
+			this->_NotifyEvicted(node.key, node.value);
+		}
+
+		void _FreeNode(Shard& shard, size_t hash, uint32_t index)
+		{
+			uint32_t* link = &_GetBucket(shard, hash);
+			while (*link != index)
+				link = &_GetNode(shard, *link).hashNext;
+			*link = _GetNode(shard, index).hashNext;
+
+			_Unlink(shard, index);
+			_GetNode(shard, index).next = shard.freeHead;
+			shard.freeHead = index;
+			--shard.size;
+		}
+
+	private:
+		char* m_base;
+		size_t m_segmentSize;
+	};
+}
+
+#endif
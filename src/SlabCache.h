@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	// Size-classed slab allocator for value payloads.
+	// Each size class carves fixed-size slots out of large slabs and recycles them through a free list,
+	// so churn never hands memory back to malloc and RSS stays flat once the classes are warm.
+	class SlabStore
+	{
+	public:
+		struct Slot
+		{
+			std::atomic<uint32_t> refs;
+			uint32_t size;        // payload bytes
+			uint32_t sizeClass;   // index into m_classes, LARGE_CLASS for oversized payloads
+			uint32_t padding;
+			Slot* nextFree;       // only meaningful while the slot sits on a free list
+
+			char* Data() { return reinterpret_cast<char*>(this + 1); }
+		};
+
+		static constexpr uint32_t LARGE_CLASS = UINT32_MAX;
+		static constexpr size_t MIN_SLOT_SIZE = 64;
+		static constexpr size_t MAX_SLOT_SIZE = 8192;
+		static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+		// useHugePages: back slabs with 2 MiB pages where the platform allows it (falls back silently); slabs are
+		// then rounded up to whole huge pages
+		explicit SlabStore(bool useHugePages = false, size_t slabSize = 256 * 1024)
+			: m_useHugePages(useHugePages),
+			m_slabSize(useHugePages
+				? (std::max(slabSize, HUGE_PAGE_SIZE) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE
+				: std::max(slabSize, MAX_SLOT_SIZE)),
+			m_reservedBytes(0), m_slotsInUse(0), m_largeAllocations(0), m_hugePageSlabs(0)
+		{
+			// ~1.25x growth between classes keeps internal waste low for variable-length strings
+			for (size_t slot_size = MIN_SLOT_SIZE; slot_size < MAX_SLOT_SIZE; )
+			{
+				m_classes.emplace_back(std::make_unique<SizeClass>(slot_size));
+				slot_size = (slot_size * 5 / 4 + 15) & ~size_t(15);
+			}
+			m_classes.emplace_back(std::make_unique<SizeClass>(MAX_SLOT_SIZE));
+		}
+
+		~SlabStore()
+		{
+			for (auto& slab : m_slabs)
+				_ReleaseSlab(slab);
+		}
+
+		SlabStore(const SlabStore&) = delete;
+		SlabStore& operator=(const SlabStore&) = delete;
+
+		Slot* Allocate(size_t size)
+		{
+			size_t needed = sizeof(Slot) + size;
+			Slot* slot = nullptr;
+			uint32_t class_index = _FindClass(needed);
+			if (class_index == LARGE_CLASS)
+			{
+				slot = static_cast<Slot*>(::operator new(needed));
+				m_largeAllocations.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				slot = _PopFree(class_index);
+			}
+
+			new (&slot->refs) std::atomic<uint32_t>(1);
+			slot->size = static_cast<uint32_t>(size);
+			slot->sizeClass = class_index;
+			slot->nextFree = nullptr;
+			m_slotsInUse.fetch_add(1, std::memory_order_relaxed);
+			return slot;
+		}
+
+		void Free(Slot* slot)
+		{
+			m_slotsInUse.fetch_sub(1, std::memory_order_relaxed);
+			if (slot->sizeClass == LARGE_CLASS)
+			{
+				m_largeAllocations.fetch_sub(1, std::memory_order_relaxed);
+				::operator delete(slot);
+				return;
+			}
+
+			SizeClass& size_class = *m_classes[slot->sizeClass];
+			std::lock_guard<std::mutex> lock(size_class.mutex);
+			slot->nextFree = size_class.freeList;
+			size_class.freeList = slot;
+		}
+
+		size_t ReservedBytes() const { return m_reservedBytes.load(std::memory_order_relaxed); }
+		size_t SlotsInUse() const { return m_slotsInUse.load(std::memory_order_relaxed); }
+		size_t LargeAllocations() const { return m_largeAllocations.load(std::memory_order_relaxed); }
+		size_t HugePageSlabs() const { return m_hugePageSlabs.load(std::memory_order_relaxed); }
+
+	private:
+		struct SizeClass
+		{
+			explicit SizeClass(size_t slotSize) : slotSize(slotSize), freeList(nullptr) {}
+
+			size_t slotSize;
+			Slot* freeList;
+			std::mutex mutex;
+		};
+
+		struct Slab
+		{
+			char* data;
+			size_t bytes;
+			bool mapped;
+		};
+
+		uint32_t _FindClass(size_t needed) const
+		{
+			if (needed > MAX_SLOT_SIZE)
+				return LARGE_CLASS;
+
+			auto it = std::lower_bound(m_classes.begin(), m_classes.end(), needed,
+				[](const std::unique_ptr<SizeClass>& size_class, size_t bytes) { return size_class->slotSize < bytes; });
+			return static_cast<uint32_t>(it - m_classes.begin());
+		}
+
+		Slot* _PopFree(uint32_t classIndex)
+		{
+			SizeClass& size_class = *m_classes[classIndex];
+			std::lock_guard<std::mutex> lock(size_class.mutex);
+			if (!size_class.freeList)
+				_CarveSlab(size_class);
+
+			Slot* slot = size_class.freeList;
+			size_class.freeList = slot->nextFree;
+			return slot;
+		}
+
+		// caller holds sizeClass.mutex
+		void _CarveSlab(SizeClass& sizeClass)
+		{
+			Slab slab = _AllocateSlab();
+			size_t slot_count = slab.bytes / sizeClass.slotSize;
+			for (size_t i = slot_count; i-- > 0; )
+			{
+				Slot* slot = reinterpret_cast<Slot*>(slab.data + i * sizeClass.slotSize);
+				slot->nextFree = sizeClass.freeList;
+				sizeClass.freeList = slot;
+			}
+
+			std::lock_guard<std::mutex> lock(m_slabMutex);
+			m_slabs.push_back(slab);
+		}
+
+		Slab _AllocateSlab()
+		{
+			m_reservedBytes.fetch_add(m_slabSize, std::memory_order_relaxed);
+#if defined(__linux__)
+			if (m_useHugePages)
+			{
+				void* mem = mmap(nullptr, m_slabSize, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+				if (mem == MAP_FAILED)
+				{
+					// no reserved hugetlbfs pages: ask for transparent huge pages instead
+					mem = _MapHugeAligned();
+					if (mem != MAP_FAILED)
+						madvise(mem, m_slabSize, MADV_HUGEPAGE);
+				}
+				else
+				{
+					m_hugePageSlabs.fetch_add(1, std::memory_order_relaxed);
+				}
+
+				if (mem != MAP_FAILED)
+					return Slab{ static_cast<char*>(mem), m_slabSize, true };
+			}
+#endif
+			return Slab{ static_cast<char*>(::operator new(m_slabSize)), m_slabSize, false };
+		}
+
+#if defined(__linux__)
+		// A plain mmap is only page-aligned, and THP can only back huge pages that lie wholly inside the range,
+		// so map one huge page extra and trim both ends to leave a 2 MiB-aligned slab.
+		void* _MapHugeAligned()
+		{
+			size_t span = m_slabSize + HUGE_PAGE_SIZE;
+			void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (raw == MAP_FAILED)
+				return MAP_FAILED;
+
+			uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+			uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(uintptr_t(HUGE_PAGE_SIZE) - 1);
+			if (aligned > start)
+				munmap(raw, aligned - start);
+			size_t tail = start + span - (aligned + m_slabSize);
+			if (tail > 0)
+				munmap(reinterpret_cast<void*>(aligned + m_slabSize), tail);
+			return reinterpret_cast<void*>(aligned);
+		}
+#endif
+
+		void _ReleaseSlab(const Slab& slab)
+		{
+#if defined(__linux__)
+			if (slab.mapped)
+			{
+				munmap(slab.data, slab.bytes);
+				return;
+			}
+#endif
+			::operator delete(slab.data);
+		}
+
+	private:
+		bool m_useHugePages;
+		size_t m_slabSize;
+		std::atomic<size_t> m_reservedBytes;
+		std::atomic<size_t> m_slotsInUse;
+		std::atomic<size_t> m_largeAllocations;
+		std::atomic<size_t> m_hugePageSlabs;
+
+		std::vector<std::unique_ptr<SizeClass>> m_classes;   // sorted by slotSize
+		std::mutex m_slabMutex;
+		std::vector<Slab> m_slabs;
+	};
+
+	// Ref-counted handle to a payload held in a SlabStore.
+	// Copies share the slot; the last handle to go (normally the evicted node's) puts it back on the free list.
+	class SlabValue
+	{
+	public:
+		SlabValue() : m_store(nullptr), m_slot(nullptr) {}
+
+		SlabValue(SlabStore& store, std::string_view bytes)
+			: m_store(&store), m_slot(store.Allocate(bytes.size()))
+		{
+			std::memcpy(m_slot->Data(), bytes.data(), bytes.size());
+		}
+
+		SlabValue(const SlabValue& other) : m_store(other.m_store), m_slot(other.m_slot)
+		{
+			if (m_slot)
+				m_slot->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		SlabValue(SlabValue&& other) noexcept : m_store(other.m_store), m_slot(other.m_slot)
+		{
+			other.m_store = nullptr;
+			other.m_slot = nullptr;
+		}
+
+		SlabValue& operator=(SlabValue other) noexcept
+		{
+			std::swap(m_store, other.m_store);
+			std::swap(m_slot, other.m_slot);
+			return *this;
+		}
+
+		~SlabValue()
+		{
+			if (m_slot && m_slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				m_store->Free(m_slot);
+		}
+
+		std::string_view View() const
+		{
+			return m_slot ? std::string_view(m_slot->Data(), m_slot->size) : std::string_view();
+		}
+
+	private:
+		SlabStore* m_store;
+		SlabStore::Slot* m_slot;
+	};
+
+	// std::string cache whose payload bytes live in a SlabStore owned by the cache.
+	// Any policy works as the inner cache; it only ever sees 16-byte SlabValue handles.
+	template<typename Key>
+	class SlabStringCache : public ICachePolicy<Key, std::string>
+	{
+	public:
+		using InnerCache = ICachePolicy<Key, SlabValue>;
+
+		// makeCache: builds the inner policy, e.g. [](int cap) { return std::make_unique<LRUCache<int, SlabValue>>(cap); }
+		template<typename MakeCache>
+		SlabStringCache(int capacity, MakeCache makeCache, bool useHugePages = false)
+			: m_store(std::make_unique<SlabStore>(useHugePages)),
+			m_cache(makeCache(capacity))
+		{
+		}
+
+		void Put(const Key& key, const std::string& value) override
+		{
+			m_cache->Put(key, SlabValue(*m_store, value));
+		}
+
+		void Put(const Key& key, std::string&& value) override
+		{
+			m_cache->Put(key, SlabValue(*m_store, value));
+		}
+
+		bool Get(const Key& key, std::string& value) override
+		{
+			SlabValue handle;
+			if (!m_cache->Get(key, handle))
+				return false;
+
+			value.assign(handle.View());
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override { m_cache->Remove(key); }
+
+		virtual size_t Size() const override { return m_cache->Size(); }
+
+		virtual size_t Capacity() const override { return m_cache->Capacity(); }
+
+		virtual void SetEvictionCallback(typename ICachePolicy<Key, std::string>::EvictionCallback callback) override
+		{
+			if (!callback)
+			{
+				m_cache->SetEvictionCallback(nullptr);
+				return;
+			}
+			m_cache->SetEvictionCallback([callback](const Key& key, const SlabValue& value) {
+				callback(key, std::string(value.View()));
+			});
+		}
+
+		const SlabStore& Store() const { return *m_store; }
+
+	private:
+		// declared first so it outlives every handle held by m_cache
+		std::unique_ptr<SlabStore> m_store;
+		std::unique_ptr<InnerCache> m_cache;
+	};
+}
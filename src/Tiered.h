@@ -0,0 +1,555 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	// Byte encoding used by the disk tier. Trivially copyable types are stored as-is, std::string as its bytes;
+	// specialise DiskCodec for anything else.
+	template<typename T, typename = void>
+	struct DiskCodec;
+
+	template<typename T>
+	struct DiskCodec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>>
+	{
+		static void Encode(const T& value, std::string& out)
+		{
+			out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		static bool Decode(const char* data, size_t size, T& value)
+		{
+			if (size != sizeof(T)) return false;
+			std::memcpy(&value, data, sizeof(T));
+			return true;
+		}
+	};
+
+	template<>
+	struct DiskCodec<std::string>
+	{
+		static void Encode(const std::string& value, std::string& out) { out.append(value); }
+
+		static bool Decode(const char* data, size_t size, std::string& value)
+		{
+			value.assign(data, size);
+			return true;
+		}
+	};
+
+	// Log-structured store for entries demoted from a memory tier.
+	// Demote() only queues the entry; a background thread appends queued entries in batches to the active
+	// segment file, one write per batch. Only the index (key -> segment, offset, length) stays in memory.
+	// Space is reclaimed a whole segment at a time, oldest first, as soon as a batch takes the directory past
+	// maxBytes; segments are capped at a quarter of maxBytes so that happens in reasonably small steps. The active
+	// segment is never dropped, so only a single batch larger than maxBytes can leave the directory above it.
+	// A batch whose write fails goes back to the queue and is retried on a fresh segment; after
+	// MAX_WRITE_RETRIES failures in a row it is dropped. WriteFailures() and LostEntries() report both.
+	template<typename Key, typename Value>
+	class DiskTier
+	{
+	public:
+		static constexpr size_t MAX_WRITE_RETRIES = 3;
+
+		DiskTier(const std::string& directory, size_t maxBytes, size_t batchSize = 256,
+			size_t segmentBytes = 16 * 1024 * 1024)
+			: m_directory(directory), m_maxBytes(maxBytes), m_batchSize(batchSize > 0 ? batchSize : 1),
+			m_segmentBytes(std::max<size_t>(4096, std::min(segmentBytes, maxBytes / 4))),
+			m_activeSegment(0), m_activeBytes(0), m_totalBytes(0), m_writeFailures(0), m_lostEntries(0),
+			m_failedAttempts(0), m_stop(false), m_flushing(false)
+		{
+			// the index is not persisted, so segments left by an earlier run are unreachable; anything else in
+			// the directory is not ours and stays
+			std::filesystem::create_directories(m_directory);
+			for (const auto& file : std::filesystem::directory_iterator(m_directory))
+			{
+				if (file.is_regular_file() && _IsSegmentName(file.path().filename().string()))
+					std::filesystem::remove(file.path());
+			}
+			_OpenSegment(0);
+			m_writer = std::thread([this] { _WriterLoop(); });
+		}
+
+		~DiskTier()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_wakeWriter.notify_one();
+			m_writer.join();
+		}
+
+		DiskTier(const DiskTier&) = delete;
+		DiskTier& operator=(const DiskTier&) = delete;
+
+		void Demote(const Key& key, const Value& value)
+		{
+			bool wake = false;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pending[key] = value;
+				wake = m_pending.size() >= m_batchSize;
+			}
+			if (wake)
+				m_wakeWriter.notify_one();
+		}
+
+		bool Get(const Key& key, Value& value)
+		{
+			Location location;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto pending = m_pending.find(key);
+				if (pending != m_pending.end())
+				{
+					value = pending->second;
+					return true;
+				}
+				auto in_flight = m_inFlight.find(key);
+				if (in_flight != m_inFlight.end())
+				{
+					value = in_flight->second;
+					return true;
+				}
+				auto it = m_index.find(key);
+				if (it == m_index.end())
+					return false;
+				location = it->second;
+			}
+
+			return _ReadRecord(location, value);
+		}
+
+		// Drops the disk copy, e.g. because the memory tier now holds a newer value.
+		void Invalidate(const Key& key)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pending.erase(key);
+			m_inFlight.erase(key);
+			m_index.erase(key);
+		}
+
+		// Blocks until everything demoted so far is on disk.
+		void Flush()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_flushRequested = true;
+			m_wakeWriter.notify_one();
+			m_flushed.wait(lock, [this] { return m_pending.empty() && m_inFlight.empty() && !m_flushing; });
+		}
+
+		size_t IndexedEntries()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_index.size();
+		}
+
+		size_t DiskBytes() const { return m_totalBytes.load(std::memory_order_relaxed); }
+
+		// batch writes that failed, and demoted entries given up on after MAX_WRITE_RETRIES of them
+		size_t WriteFailures() const { return m_writeFailures.load(std::memory_order_relaxed); }
+		size_t LostEntries() const { return m_lostEntries.load(std::memory_order_relaxed); }
+
+	private:
+		struct Location
+		{
+			uint32_t segment;
+			uint32_t length;   // value bytes
+			uint64_t offset;   // of the value bytes within the segment
+		};
+
+		struct RecordHeader
+		{
+			uint32_t keyLength;
+			uint32_t valueLength;
+		};
+
+		// a file open for reads of one segment; reads of the same segment take turns on it
+		struct SegmentReader
+		{
+			std::mutex mutex;
+			std::ifstream in;
+		};
+
+		std::string _SegmentPath(uint32_t segment) const
+		{
+			return (std::filesystem::path(m_directory) / ("segment-" + std::to_string(segment) + ".log")).string();
+		}
+
+		// "segment-<n>.log", the names _SegmentPath produces
+		static bool _IsSegmentName(const std::string& name)
+		{
+			const std::string prefix = "segment-";
+			const std::string suffix = ".log";
+			if (name.size() <= prefix.size() + suffix.size()
+				|| name.compare(0, prefix.size(), prefix) != 0
+				|| name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+				return false;
+			return std::all_of(name.begin() + prefix.size(), name.end() - suffix.size(),
+				[](char c) { return c >= '0' && c <= '9'; });
+		}
+
+		// caller is the writer thread, or the constructor before it starts
+		void _OpenSegment(uint32_t segment)
+		{
+			m_active.close();
+			m_active.open(_SegmentPath(segment), std::ios::binary | std::ios::out | std::ios::trunc);
+			m_activeSegment = segment;
+			m_activeBytes = 0;
+			std::lock_guard<std::mutex> lock(m_segmentMutex);
+			m_segmentSizes[segment] = 0;
+		}
+
+		void _WriterLoop()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (true)
+			{
+				// a partial batch still goes out after a short delay so demoted entries don't linger in RAM
+				m_wakeWriter.wait_for(lock, std::chrono::milliseconds(50), [this] {
+					return m_stop || m_flushRequested || m_pending.size() >= m_batchSize;
+				});
+
+				if (!m_pending.empty())
+				{
+					m_inFlight.swap(m_pending);
+					m_flushing = true;
+					_WriteBatch(lock);
+					m_flushing = false;
+				}
+
+				if (m_pending.empty())
+				{
+					m_flushRequested = false;
+					m_flushed.notify_all();
+				}
+
+				if (m_stop && m_pending.empty())
+					return;
+			}
+		}
+
+		// Called with lock held on m_mutex; releases it around the file write.
+		void _WriteBatch(std::unique_lock<std::mutex>& lock)
+		{
+			if (m_activeBytes >= m_segmentBytes)
+			{
+				lock.unlock();
+				_OpenSegment(m_activeSegment + 1);
+				lock.lock();
+				_EnforceCapacity();
+			}
+
+			std::string buffer;
+			std::vector<std::pair<Key, Location>> written;
+			written.reserve(m_inFlight.size());
+			for (const auto& entry : m_inFlight)
+			{
+				size_t start = buffer.size();
+				buffer.resize(start + sizeof(RecordHeader));
+				DiskCodec<Key>::Encode(entry.first, buffer);
+				size_t value_start = buffer.size();
+				DiskCodec<Value>::Encode(entry.second, buffer);
+
+				RecordHeader header{ static_cast<uint32_t>(value_start - start - sizeof(RecordHeader)),
+					static_cast<uint32_t>(buffer.size() - value_start) };
+				std::memcpy(&buffer[start], &header, sizeof(header));
+				written.emplace_back(entry.first, Location{ m_activeSegment, header.valueLength,
+					m_activeBytes + value_start });
+			}
+
+			lock.unlock();
+			m_active.write(buffer.data(), buffer.size());
+			m_active.flush();
+			bool ok = static_cast<bool>(m_active);
+			lock.lock();
+
+			if (!ok)
+			{
+				_HandleFailedWrite(lock);
+				return;
+			}
+			m_failedAttempts = 0;
+			m_activeBytes += buffer.size();
+			m_totalBytes.fetch_add(buffer.size(), std::memory_order_relaxed);
+			{
+				std::lock_guard<std::mutex> segment_lock(m_segmentMutex);
+				m_segmentSizes[m_activeSegment] += buffer.size();
+			}
+
+			// anything invalidated while the write was in progress has left m_inFlight and stays out
+			for (const auto& record : written)
+			{
+				if (m_inFlight.find(record.first) != m_inFlight.end())
+					m_index[record.first] = record.second;
+			}
+			m_inFlight.clear();
+			_EnforceCapacity();
+		}
+
+		// Called with lock held on m_mutex after a batch failed to write. The batch goes back to m_pending
+		// (entries demoted again meanwhile keep their newer value) unless it has failed MAX_WRITE_RETRIES times
+		// in a row, so a dead disk neither grows m_pending without bound nor blocks Flush() forever.
+		// The stream stays failed and the segment may end in a partial record, so writing moves on to a fresh one.
+		void _HandleFailedWrite(std::unique_lock<std::mutex>& lock)
+		{
+			m_writeFailures.fetch_add(1, std::memory_order_relaxed);
+			if (++m_failedAttempts <= MAX_WRITE_RETRIES)
+			{
+				for (auto& entry : m_inFlight)
+					m_pending.emplace(entry.first, std::move(entry.second));
+			}
+			else
+			{
+				m_lostEntries.fetch_add(m_inFlight.size(), std::memory_order_relaxed);
+				m_failedAttempts = 0;
+			}
+			m_inFlight.clear();
+
+			// a segment holding no records is simply rewritten; otherwise its partial tail counts against the budget
+			uint32_t segment = m_activeSegment;
+			bool has_records = m_activeBytes > 0;
+			lock.unlock();
+			size_t partial = 0;
+			if (has_records)
+			{
+				std::error_code ec;
+				uintmax_t size = std::filesystem::file_size(_SegmentPath(segment), ec);
+				if (!ec && size > m_activeBytes)
+					partial = static_cast<size_t>(size - m_activeBytes);
+			}
+			_OpenSegment(has_records ? segment + 1 : segment);
+			lock.lock();
+
+			if (partial > 0)
+			{
+				m_totalBytes.fetch_add(partial, std::memory_order_relaxed);
+				std::lock_guard<std::mutex> segment_lock(m_segmentMutex);
+				m_segmentSizes[segment] += partial;
+			}
+		}
+
+		// caller holds m_mutex
+		void _EnforceCapacity()
+		{
+			std::lock_guard<std::mutex> segment_lock(m_segmentMutex);
+			while (m_totalBytes.load(std::memory_order_relaxed) > m_maxBytes && m_segmentSizes.size() > 1)
+			{
+				auto oldest = m_segmentSizes.begin();
+				uint32_t segment = oldest->first;
+				for (auto it = m_index.begin(); it != m_index.end(); )
+				{
+					if (it->second.segment == segment)
+						it = m_index.erase(it);
+					else
+						++it;
+				}
+				m_totalBytes.fetch_sub(oldest->second, std::memory_order_relaxed);
+				m_segmentSizes.erase(oldest);
+				// a read still holding the reader finishes on the open handle
+				m_readers.erase(segment);
+				std::error_code ec;
+				std::filesystem::remove(_SegmentPath(segment), ec);
+			}
+		}
+
+		bool _ReadRecord(const Location& location, Value& value)
+		{
+			std::shared_ptr<SegmentReader> reader = _GetReader(location.segment);
+			if (!reader)
+				return false;
+
+			std::string buffer(location.length, '\0');
+			{
+				std::lock_guard<std::mutex> lock(reader->mutex);
+				// seeking drops the stream's read buffer, so bytes the writer appended since are seen
+				reader->in.clear();
+				reader->in.seekg(static_cast<std::streamoff>(location.offset));
+				reader->in.read(&buffer[0], location.length);
+				if (!reader->in)
+					return false;
+			}
+			return DiskCodec<Value>::Decode(buffer.data(), buffer.size(), value);
+		}
+
+		// opened on a segment's first read and kept until the segment is dropped
+		std::shared_ptr<SegmentReader> _GetReader(uint32_t segment)
+		{
+			std::lock_guard<std::mutex> lock(m_segmentMutex);
+			// a segment dropped by _EnforceCapacity after the index lookup simply reads as a miss
+			if (m_segmentSizes.find(segment) == m_segmentSizes.end())
+				return nullptr;
+
+			std::shared_ptr<SegmentReader>& reader = m_readers[segment];
+			if (!reader)
+			{
+				reader = std::make_shared<SegmentReader>();
+				reader->in.open(_SegmentPath(segment), std::ios::binary);
+				if (!reader->in)
+				{
+					m_readers.erase(segment);
+					return nullptr;
+				}
+			}
+			return reader;
+		}
+
+	private:
+		std::string m_directory;
+		size_t m_maxBytes;
+		size_t m_batchSize;
+		size_t m_segmentBytes;
+
+		std::ofstream m_active;          // owned by the writer thread
+		uint32_t m_activeSegment;
+		size_t m_activeBytes;
+		std::atomic<size_t> m_totalBytes;
+		std::atomic<size_t> m_writeFailures;
+		std::atomic<size_t> m_lostEntries;
+		size_t m_failedAttempts;         // consecutive failed batches, writer thread only
+
+		std::mutex m_mutex;
+		std::unordered_map<Key, Value> m_pending;    // demoted, not yet handed to the writer
+		std::unordered_map<Key, Value> m_inFlight;   // being written right now
+		std::unordered_map<Key, Location> m_index;
+		bool m_stop;
+		bool m_flushing;
+		bool m_flushRequested = false;
+		std::condition_variable m_wakeWriter;
+		std::condition_variable m_flushed;
+
+		std::mutex m_segmentMutex;
+		std::map<uint32_t, size_t> m_segmentSizes;   // ordered by age
+		std::unordered_map<uint32_t, std::shared_ptr<SegmentReader>> m_readers;
+		std::thread m_writer;
+	};
+
+	// Memory policy backed by a DiskTier: whatever the memory tier evicts is demoted to disk instead of lost,
+	// and a disk hit is promoted back into memory (which may in turn demote something else). The disk copy is
+	// kept whenever the memory tier declines the promotion.
+	// The disk read happens outside the cache lock so memory hits never queue behind file I/O; a Put or Remove
+	// landing meanwhile is detected by m_generation and the lookup is redone under the lock.
+	template<typename Key, typename Value>
+	class TieredCache : public ICachePolicy<Key, Value>
+	{
+	public:
+		TieredCache(std::unique_ptr<ICachePolicy<Key, Value>> memory, const std::string& directory,
+			size_t diskBytes, size_t batchSize = 256)
+			: m_disk(std::make_unique<DiskTier<Key, Value>>(directory, diskBytes, batchSize)),
+			m_memory(std::move(memory)), m_memoryHits(0), m_diskHits(0), m_generation(0)
+		{
+			m_memory->SetEvictionCallback([this](const Key& key, const Value& value) {
+				m_disk->Demote(key, value);
+			});
+		}
+
+		virtual ~TieredCache() override
+		{
+			// the memory tier goes first; stop it from demoting into a disk tier being torn down
+			m_memory->SetEvictionCallback(nullptr);
+		}
+
+		void Put(const Key& key, const Value& value) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_generation;
+			m_disk->Invalidate(key);
+			m_memory->Put(key, value);
+		}
+
+		void Put(const Key& key, Value&& value) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_generation;
+			m_disk->Invalidate(key);
+			m_memory->Put(key, std::move(value));
+		}
+
+		bool Get(const Key& key, Value& value) override
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_memory->Get(key, value))
+			{
+				++m_memoryHits;
+				return true;
+			}
+			size_t generation = m_generation;
+			lock.unlock();
+
+			bool found = m_disk->Get(key, value);
+
+			lock.lock();
+			if (generation != m_generation)
+			{
+				// key may have been written or removed while we read; what is current now decides
+				if (m_memory->Get(key, value))
+				{
+					++m_memoryHits;
+					return true;
+				}
+				found = m_disk->Get(key, value);
+			}
+			if (!found)
+				return false;
+
+			++m_diskHits;
+			// the disk copy only goes once memory really holds the entry: admission-filtered policies (LRU-K) and
+			// zero-capacity ones accept a Put without keeping it
+			m_memory->Put(key, value);
+			Value resident{};
+			if (m_memory->Get(key, resident))
+				m_disk->Invalidate(key);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_generation;
+			m_memory->Remove(key);
+			m_disk->Invalidate(key);
+		}
+
+		// Memory-resident entries only; the disk tier is bounded in bytes, see DiskBytes().
+		virtual size_t Size() const override { return m_memory->Size(); }
+
+		virtual size_t Capacity() const override { return m_memory->Capacity(); }
+
+		void Flush() { m_disk->Flush(); }
+
+		size_t MemoryHits() const { return m_memoryHits; }
+		size_t DiskHits() const { return m_diskHits; }
+		size_t DiskBytes() const { return m_disk->DiskBytes(); }
+		size_t DiskEntries() { return m_disk->IndexedEntries(); }
+		size_t DiskWriteFailures() const { return m_disk->WriteFailures(); }
+		size_t DiskLostEntries() const { return m_disk->LostEntries(); }
+
+	private:
+		std::mutex m_mutex;
+		// declared before m_memory so it is still alive while the memory tier is destroyed
+		std::unique_ptr<DiskTier<Key, Value>> m_disk;
+		std::unique_ptr<ICachePolicy<Key, Value>> m_memory;
+		size_t m_memoryHits;
+		size_t m_diskHits;
+		size_t m_generation;   // bumped by every Put and Remove
+	};
+}
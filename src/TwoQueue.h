@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Node.h"
+#include "CachePolicy.h"
+
+namespace CacheCpp {
+
+	// 2Q (full version)
+	// A1in: FIFO of first-time residents, A1out: FIFO of keys recently evicted from A1in (no payload),
+	// Am: LRU of keys that were referenced again while remembered in A1out.
+	// One-shot keys from a scan pass through A1in and never reach Am.
+	template<typename Key, typename Value>
+	class TwoQueueCache : public ICachePolicy<Key, Value>
+	{
+	public:
+		using typename ICachePolicy<Key, Value>::NodeType;
+		using typename ICachePolicy<Key, Value>::NodePtr;
+		using GhostNode = Node<Key, bool>;
+		using GhostNodePtr = std::shared_ptr<GhostNode>;
+
+		// inRatio:    share of capacity reserved for A1in (Kin)
+		// outRatio:   number of remembered A1out keys, as a multiple of capacity (Kout)
+		TwoQueueCache(int capacity, double inRatio = 0.25, double outRatio = 0.5)
+			: m_capacity(capacity), m_inCount(0),
+			m_in(std::make_unique<LinkedList<Key, Value>>()),
+			m_main(std::make_unique<LinkedList<Key, Value>>()),
+			m_out(std::make_unique<LinkedList<Key, bool>>())
+		{
+			m_inCapacity = std::max(1, static_cast<int>(capacity * inRatio));
+			m_outCapacity = std::max(1, static_cast<int>(capacity * outRatio));
+		}
+
+		virtual ~TwoQueueCache() override = default;
+
+		void Put(const Key& key, const Value& value) override { Emplace(key, value); }
+
+		void Put(const Key& key, Value&& value) override { Emplace(key, std::move(value)); }
+
+		template<typename... Args>
+		void Emplace(const Key& key, Args&&... args)
+		{
+			if (m_capacity <= 0)
+				return;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (it != m_caches.end())
+			{
+				it->second.node->EmplaceValue(std::forward<Args>(args)...);
+				if (it->second.inMain)
+					_MoveToMostRecent(it->second.node);
+				return;
+			}
+
+			_Reclaim();
+
+			auto ghost = m_ghosts.find(key);
+			if (ghost != m_ghosts.end())
+			{
+				// re-referenced after leaving A1in: it is part of the long-term working set
+				m_out->RemoveNode(ghost->second);
+				m_ghosts.erase(ghost);
+				_AddNewNode(key, true, std::forward<Args>(args)...);
+				return;
+			}
+
+			_AddNewNode(key, false, std::forward<Args>(args)...);
+		}
+
+		bool Get(const Key& key, Value& value) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (it == m_caches.end())
+				return false;
+
+			value = it->second.node->GetValue();
+			// hits in A1in are deliberately ignored: correlated references must not promote
+			if (it->second.inMain)
+				_MoveToMostRecent(it->second.node);
+			return true;
+		}
+
+		virtual void Remove(const Key& key) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto it = m_caches.find(key);
+			if (it != m_caches.end())
+			{
+				_Unlink(it->second);
+				m_caches.erase(it);
+				return;
+			}
+
+			auto ghost = m_ghosts.find(key);
+			if (ghost != m_ghosts.end())
+			{
+				m_out->RemoveNode(ghost->second);
+				m_ghosts.erase(ghost);
+			}
+		}
+
+		virtual size_t Size() const override { return m_caches.size(); }
+
+		virtual size_t Capacity() const override { return m_capacity; }
+
+	private:
+		struct Entry
+		{
+			NodePtr node;
+			bool inMain;   // true: Am, false: A1in
+		};
+
+		template<typename... Args>
+		void _AddNewNode(const Key& key, bool inMain, Args&&... args)
+		{
+			NodePtr new_node = std::make_shared<NodeType>(key, std::forward<Args>(args)...);
+			if (inMain)
+			{
+				m_main->InsertNode(new_node);
+			}
+			else
+			{
+				m_in->InsertNode(new_node);
+				++m_inCount;
+			}
+			m_caches[key] = Entry{ new_node, inMain };
+		}
+
+		void _MoveToMostRecent(const NodePtr& node)
+		{
+			m_main->RemoveNode(node);
+			m_main->InsertNode(node);
+		}
+
+		void _Reclaim()
+		{
+			if (m_caches.size() < static_cast<size_t>(m_capacity))
+				return;
+
+			if (m_inCount > m_inCapacity || m_main->IsEmpty())
+			{
+				NodePtr oldest = m_in->GetLastNode();
+				if (!oldest) return;
+
+				m_in->RemoveNode(oldest);
+				--m_inCount;
+				m_caches.erase(oldest->GetKey());
+				_RememberEvicted(oldest->GetKey());
+				this->_NotifyEvicted(oldest->GetKey(), oldest->GetValue());
+			}
+			else
+			{
+				NodePtr least_recent = m_main->GetLastNode();
+				m_main->RemoveNode(least_recent);
+				m_caches.erase(least_recent->GetKey());
+				this->_NotifyEvicted(least_recent->GetKey(), least_recent->GetValue());
+			}
+		}
+
+		void _RememberEvicted(const Key& key)
+		{
+			GhostNodePtr ghost = std::make_shared<GhostNode>(key, false);
+			m_out->InsertNode(ghost);
+			m_ghosts[key] = ghost;
+
+			if (m_ghosts.size() > static_cast<size_t>(m_outCapacity))
+			{
+				GhostNodePtr oldest = m_out->GetLastNode();
+				m_out->RemoveNode(oldest);
+				m_ghosts.erase(oldest->GetKey());
+			}
+		}
+
+		void _Unlink(const Entry& entry)
+		{
+			if (entry.inMain)
+			{
+				m_main->RemoveNode(entry.node);
+			}
+			else
+			{
+				m_in->RemoveNode(entry.node);
+				--m_inCount;
+			}
+		}
+
+	private:
+		int m_capacity;
+		int m_inCapacity;
+		int m_outCapacity;
+		int m_inCount;
+
+		std::mutex m_mutex;
+		std::unordered_map<Key, Entry> m_caches;
+		std::unordered_map<Key, GhostNodePtr> m_ghosts;
+		std::unique_ptr<LinkedList<Key, Value>> m_in;     // A1in, GetLastNode() is the oldest
+		std::unique_ptr<LinkedList<Key, Value>> m_main;   // Am, GetLastNode() is the least recent
+		std::unique_ptr<LinkedList<Key, bool>> m_out;     // A1out, GetLastNode() is the oldest
+	};
+}
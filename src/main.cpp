@@ -6,20 +6,73 @@
 #include <random>
 #include <algorithm>
 #include <array>
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
 
 
 #include "CachePolicy.h"
 #include "LFU.h"
 #include "LRU.h"
 #include "ARC.h"
+#include "LIRS.h"
+#include "TwoQueue.h"
+#include "SlabCache.h"
+#include "SharedMemoryCache.h"
+#include "Tiered.h"
+#include "GDSF.h"
+#include "SeqlockHash.h"
+#include "Adaptive.h"
+
+#if CACHECPP_HAS_SHARED_MEMORY
+#include <sys/wait.h>
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 enum class AccessPattern {
 	Hotspot,
 	Random,
-	// Future: Zipf, Scan
+	Scan,      // hotspot traffic interrupted by sequential one-shot scans
+	// Future: Zipf
 };
 
 namespace Test {
+	// every global operator new bumps this, see the replacements below
+	std::atomic<size_t> g_allocations{ 0 };
+}
+
+void* operator new(std::size_t size) {
+	Test::g_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace Test {
+	// resident set size of this process in KiB, 0 where /proc/self/statm is unavailable
+	inline size_t ResidentKiB() {
+#if defined(__linux__)
+		std::ifstream statm("/proc/self/statm");
+		size_t total_pages = 0, resident_pages = 0;
+		if (statm >> total_pages >> resident_pages)
+			return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+#endif
+		return 0;
+	}
+
 	class Timer {
 	public:
 		Timer() : start(std::chrono::high_resolution_clock::now()) {}
@@ -37,7 +90,38 @@ namespace Test {
 	public:
 		static void Run(int capacity, int operations, AccessPattern pattern);
 
+		static void RunAllocations(int capacity, int operations);
+
+		static void RunMissCost(int capacity, int operations);
+
+		static void RunPhaseShift(int capacity, int phaseOperations, int phases);
+
+		static void RunSlabStore(int capacity, int operations);
+
+		static void RunSlabResidency(int capacity, int operations, int rounds);
+
+		static void RunConcurrent(int capacity, int threads, int operations, int writePercent);
+
+		static void RunNegativeLookups(int capacity, int threads, int operations, int missPercent);
+
+		static void RunReadScaling(int capacity, int maxThreads, int operations);
+
+		static void RunSharedMemory(int capacity, int processes, int operations);
+
+		static void RunTiered(int capacity, int workingSet, int operations);
+
 	private:
+		template<typename Cache, typename MakeCache>
+		static void RunAllocationTest(const std::string& name, MakeCache makeCache, int capacity, int operations);
+
+		static int NextKey(AccessPattern pattern, int op, std::mt19937& gen);
+
+		static void RunConcurrentTest(const std::string& name,
+			CacheCpp::ICachePolicy<int, std::string>& cache,
+			int threads,
+			int operations,
+			int writePercent);
+
 		static void RunSingleTest(const std::string& name,
 			std::unique_ptr<CacheCpp::ICachePolicy<int, std::string>> cache,
 			int capacity,
@@ -68,6 +152,558 @@ namespace Test {
 		RunSingleTest("ARC",
 			std::make_unique<CacheCpp::ARCCache<int, std::string>>(capacity, 50),
 			capacity, operations, pattern);
+
+		RunSingleTest("LIRS",
+			std::make_unique<CacheCpp::LIRSCache<int, std::string>>(capacity),
+			capacity, operations, pattern);
+
+		RunSingleTest("2Q",
+			std::make_unique<CacheCpp::TwoQueueCache<int, std::string>>(capacity),
+			capacity, operations, pattern);
+
+		RunSingleTest("GDSF",
+			std::make_unique<CacheCpp::GDSFCache<int, std::string>>(capacity),
+			capacity, operations, pattern);
+
+		RunSingleTest("Adaptive",
+			std::make_unique<CacheCpp::AdaptiveCache<int, std::string>>(capacity),
+			capacity, operations, pattern);
+	}
+
+	void CacheTestRunner::RunAllocations(int capacity, int operations) {
+		std::cout << "=== Allocations per insert [capacity=" << capacity << ", inserts=" << operations
+			<< ", 256-byte values] ===\n";
+
+		using Value = std::string;
+		RunAllocationTest<CacheCpp::LRUCache<int, Value>>("LRU",
+			[capacity] { return std::make_unique<CacheCpp::LRUCache<int, Value>>(capacity); },
+			capacity, operations);
+		RunAllocationTest<CacheCpp::LRUHashCache<int, Value>>("LRU-Hash",
+			[capacity] { return std::make_unique<CacheCpp::LRUHashCache<int, Value>>(capacity, 4); },
+			capacity, operations);
+		RunAllocationTest<CacheCpp::LFUCache<int, Value>>("LFU",
+			[capacity] { return std::make_unique<CacheCpp::LFUCache<int, Value>>(capacity, 900000); },
+			capacity, operations);
+		RunAllocationTest<CacheCpp::ARCCache<int, Value>>("ARC",
+			[capacity] { return std::make_unique<CacheCpp::ARCCache<int, Value>>(capacity, 50); },
+			capacity, operations);
+		RunAllocationTest<CacheCpp::LIRSCache<int, Value>>("LIRS",
+			[capacity] { return std::make_unique<CacheCpp::LIRSCache<int, Value>>(capacity); },
+			capacity, operations);
+		RunAllocationTest<CacheCpp::TwoQueueCache<int, Value>>("2Q",
+			[capacity] { return std::make_unique<CacheCpp::TwoQueueCache<int, Value>>(capacity); },
+			capacity, operations);
+		RunAllocationTest<CacheCpp::GDSFCache<int, Value>>("GDSF",
+			[capacity] { return std::make_unique<CacheCpp::GDSFCache<int, Value>>(capacity); },
+			capacity, operations);
+	}
+
+	template<typename Cache, typename MakeCache>
+	void CacheTestRunner::RunAllocationTest(const std::string& name, MakeCache makeCache, int capacity, int operations) {
+		const size_t VALUE_SIZE = 256;
+		const std::string payload(VALUE_SIZE, 'x');
+
+		// fill first so every measured insert also evicts; fresh keys keep every insert a miss
+		auto measure = [&](auto insert) {
+			std::unique_ptr<Cache> cache = makeCache();
+			for (int key = 0; key < capacity; ++key)
+				cache->Put(key, payload);
+
+			size_t before = g_allocations.load(std::memory_order_relaxed);
+			for (int key = capacity; key < capacity + operations; ++key)
+				insert(*cache, key);
+			return double(g_allocations.load(std::memory_order_relaxed) - before) / operations;
+		};
+
+		// values for the move path are built up front so only the cache's own allocations are counted
+		std::vector<std::string> values(operations, payload);
+		double copy = measure([&](Cache& cache, int key) { cache.Put(key, payload); });
+		double move = measure([&](Cache& cache, int key) { cache.Put(key, std::move(values[key - capacity])); });
+		double emplace = measure([&](Cache& cache, int key) { cache.Emplace(key, VALUE_SIZE, 'x'); });
+
+		std::cout << std::setw(10) << name << " | " << std::fixed << std::setprecision(2)
+			<< "Put(const&): " << std::setw(5) << copy << " | "
+			<< "Put(&&): " << std::setw(5) << move << " | "
+			<< "Emplace: " << std::setw(5) << emplace << "\n";
+	}
+
+	void CacheTestRunner::RunMissCost(int capacity, int operations) {
+		std::cout << "=== Cost-annotated trace [capacity=" << capacity << ", ops=" << operations << ", read-through] ===\n";
+
+		// one key in ten is expensive to rebuild
+		auto miss_cost = [](int key) { return key % 10 == 0 ? 400.0 : 2.0; };
+
+		auto drive = [&](CacheCpp::ICachePolicy<int, std::string>& cache, AccessPattern pattern, auto put) {
+			std::mt19937 gen(5);
+			double total_cost = 0.0;
+			for (int op = 0; op < operations; ++op) {
+				int key = NextKey(pattern, op, gen);
+				std::string val;
+				if (!cache.Get(key, val)) {
+					total_cost += miss_cost(key);
+					put(key, "val" + std::to_string(key));
+				}
+			}
+			return total_cost;
+		};
+
+		// hotspot: popularity is skewed, so frequency and cost both matter
+		// uniform: frequency carries no signal and cost alone decides
+		const std::pair<AccessPattern, const char*> patterns[] = {
+			{ AccessPattern::Hotspot, "hotspot" },
+			{ AccessPattern::Random, "uniform" },
+		};
+		for (const auto& pattern : patterns) {
+			CacheCpp::LFUCache<int, std::string> lfu(capacity, 900000);
+			double lfu_cost = drive(lfu, pattern.first, [&](int key, std::string value) { lfu.Put(key, std::move(value)); });
+
+			CacheCpp::GDSFCache<int, std::string> gdsf(capacity);
+			double gdsf_cost = drive(gdsf, pattern.first, [&](int key, std::string value) {
+				gdsf.Put(key, std::move(value), miss_cost(key));
+			});
+
+			std::cout << std::fixed << std::setprecision(0)
+				<< std::setw(10) << "LFU" << " | " << std::setw(7) << pattern.second
+				<< " | Total miss cost: " << std::setw(10) << lfu_cost << "ms\n"
+				<< std::setw(10) << "GDSF" << " | " << std::setw(7) << pattern.second
+				<< " | Total miss cost: " << std::setw(10) << gdsf_cost << "ms"
+				<< " | Saved vs LFU: " << (lfu_cost - gdsf_cost) << "ms ("
+				<< std::setprecision(2) << 100.0 * (lfu_cost - gdsf_cost) / lfu_cost << "%)\n";
+		}
+	}
+
+	void CacheTestRunner::RunPhaseShift(int capacity, int phaseOperations, int phases) {
+		std::cout << "=== Phase-shifting trace [capacity=" << capacity << ", ops/phase=" << phaseOperations
+			<< ", read-through] ===\n";
+
+		// even phases: a fixed hot set mixed with one-shot keys, where frequency wins
+		// odd phases:  every key is read twice, capacity/4 new keys apart; recency wins, and a key
+		//              that is only seen once in a while must not be filtered out
+		const int hot_keys = capacity * 4 / 5;
+		const int reuse_distance = capacity / 4;
+		auto phase_keys = [&](int phase) {
+			std::mt19937 gen(17 + phase);
+			std::vector<int> keys(phaseOperations);
+			int base = 100000000 * (phase + 1);
+			for (int op = 0; op < phaseOperations; ++op) {
+				if (phase % 2 == 0)
+					keys[op] = (gen() % 2 == 0) ? static_cast<int>(gen() % hot_keys) : base + op;
+				else
+					keys[op] = (op % 2 == 0) ? base + op / 2 : base + std::max(0, op / 2 - reuse_distance);
+			}
+			return keys;
+		};
+
+		auto run_phase = [&](CacheCpp::ICachePolicy<int, std::string>& cache, const std::vector<int>& keys) {
+			int hit = 0;
+			std::string val;
+			for (int key : keys) {
+				if (cache.Get(key, val)) hit++;
+				else cache.Put(key, "val" + std::to_string(key));
+			}
+			return 100.0 * hit / keys.size();
+		};
+
+		CacheCpp::LRUCache<int, std::string> lru(capacity);
+		CacheCpp::LFUCache<int, std::string> lfu(capacity, 900000);
+		CacheCpp::AdaptiveCache<int, std::string> adaptive(capacity);
+
+		for (int phase = 0; phase < phases; ++phase) {
+			std::vector<int> keys = phase_keys(phase);
+			std::cout << std::setw(6) << "Phase " << phase << (phase % 2 == 0 ? " (frequency)" : " (recency)  ")
+				<< std::fixed << std::setprecision(2)
+				<< " | LRU: " << std::setw(6) << run_phase(lru, keys) << "%"
+				<< " | LFU: " << std::setw(6) << run_phase(lfu, keys) << "%"
+				<< " | Adaptive: " << std::setw(6) << run_phase(adaptive, keys) << "%"
+				<< " (ends on " << CacheCpp::CandidateName(adaptive.ActivePolicy()) << ")\n";
+		}
+		std::cout << "  policy switches: " << adaptive.Switches() << "\n";
+	}
+
+	void CacheTestRunner::RunSlabStore(int capacity, int operations) {
+		std::cout << "=== Slab value store [capacity=" << capacity << ", puts=" << operations
+			<< ", 100-600 byte strings] ===\n";
+
+		// a fixed pool of payloads so building the caller's value never shows up in the counts
+		std::mt19937 gen(42);
+		std::vector<std::string> payloads;
+		for (int i = 0; i < 256; ++i)
+			payloads.emplace_back(100 + gen() % 500, char('a' + i % 26));
+
+		auto churn = [&](const std::string& name, CacheCpp::ICachePolicy<int, std::string>& cache,
+			const CacheCpp::SlabStore* store) {
+			std::mt19937 key_gen(7);
+			size_t before = g_allocations.load(std::memory_order_relaxed);
+			Timer timer;
+			for (int op = 0; op < operations; ++op) {
+				int key = key_gen() % (capacity * 4);
+				cache.Put(key, payloads[op % payloads.size()]);
+			}
+			double elapsed = timer.elapsedMs();
+			double allocs = double(g_allocations.load(std::memory_order_relaxed) - before) / operations;
+
+			std::cout << std::setw(10) << name << " | " << std::fixed << std::setprecision(2)
+				<< "Allocs/put: " << std::setw(5) << allocs << " | "
+				<< "Time: " << std::setw(8) << elapsed << "ms";
+			if (store)
+				std::cout << " | Slab bytes: " << store->ReservedBytes() / 1024 << " KiB"
+				<< ", huge-page slabs: " << store->HugePageSlabs();
+			std::cout << "\n";
+		};
+
+		CacheCpp::LRUCache<int, std::string> plain(capacity);
+		churn("LRU", plain, nullptr);
+
+		auto make_lru = [](int cap) { return std::make_unique<CacheCpp::LRUCache<int, CacheCpp::SlabValue>>(cap); };
+		CacheCpp::SlabStringCache<int> slab(capacity, make_lru);
+		churn("LRU-Slab", slab, &slab.Store());
+
+		CacheCpp::SlabStringCache<int> slab_huge(capacity, make_lru, true);
+		churn("LRU-Slab2M", slab_huge, &slab_huge.Store());
+	}
+
+	void CacheTestRunner::RunSlabResidency(int capacity, int operations, int rounds) {
+		std::cout << "=== Slab residency under churn [capacity=" << capacity << ", puts/round=" << operations
+			<< ", rounds=" << rounds << ", 64-4096 byte strings] ===\n";
+
+		// sizes spread over many malloc bins, the pattern that fragments a general-purpose heap
+		std::mt19937 gen(42);
+		std::vector<std::string> payloads;
+		for (int i = 0; i < 512; ++i)
+			payloads.emplace_back(64 + gen() % 4033, char('a' + i % 26));
+
+		// one warm-up round fills the cache, then every round replaces most of it again
+		auto churn = [&](const std::string& name, CacheCpp::ICachePolicy<int, std::string>& cache,
+			const CacheCpp::SlabStore* store) {
+#if defined(__GLIBC__)
+			// hand back what earlier runs freed, so the warm figure is mostly this cache's own
+			malloc_trim(0);
+#endif
+			std::mt19937 key_gen(7);
+			std::mt19937 size_gen(11);
+			auto run_round = [&] {
+				for (int op = 0; op < operations; ++op)
+					cache.Put(key_gen() % (capacity * 4), payloads[size_gen() % payloads.size()]);
+			};
+
+			run_round();
+			size_t warm = ResidentKiB();
+			for (int round = 0; round < rounds; ++round)
+				run_round();
+			size_t after = ResidentKiB();
+
+			std::cout << std::setw(10) << name << " | RSS warm: " << std::setw(7) << warm << " KiB"
+				<< " | after churn: " << std::setw(7) << after << " KiB"
+				<< " | growth: " << std::setw(6) << static_cast<long long>(after) - static_cast<long long>(warm) << " KiB";
+			if (store)
+				std::cout << " | Slab bytes: " << store->ReservedBytes() / 1024 << " KiB";
+			std::cout << "\n";
+		};
+
+		// each cache is gone before the next starts, so its freed memory does not hide the next one's growth
+		{
+			CacheCpp::LRUCache<int, std::string> plain(capacity);
+			churn("LRU", plain, nullptr);
+		}
+		{
+			auto make_lru = [](int cap) { return std::make_unique<CacheCpp::LRUCache<int, CacheCpp::SlabValue>>(cap); };
+			CacheCpp::SlabStringCache<int> slab(capacity, make_lru);
+			churn("LRU-Slab", slab, &slab.Store());
+		}
+	}
+
+	void CacheTestRunner::RunConcurrent(int capacity, int threads, int operations, int writePercent) {
+		std::cout << "=== Concurrent hotspot [capacity=" << capacity << ", threads=" << threads
+			<< ", ops/thread=" << operations << ", writes=" << writePercent << "%] ===\n";
+
+		CacheCpp::LRUHashCache<int, std::string> sharded(capacity, 8);
+		RunConcurrentTest("LRU-Hash", sharded, threads, operations, writePercent);
+
+		CacheCpp::LRUHashCache<int, std::string> front(capacity, 8, true);
+		RunConcurrentTest("LRU-Hash+L1", front, threads, operations, writePercent);
+
+		CacheCpp::LRUHashOptions hot_options;
+		hot_options.hotKeySampleRate = 16;
+		hot_options.hotKeyReplicas = 4;
+		CacheCpp::LRUHashCache<int, std::string> replicated(capacity, 8, hot_options);
+		RunConcurrentTest("LRU-Hash+Hot", replicated, threads, operations, writePercent);
+
+		std::cout << "  detected hot keys:";
+		for (const auto& hitter : replicated.HotKeys(5))
+			std::cout << " " << hitter.key << "(" << hitter.count - hitter.error << ".." << hitter.count << ")";
+		std::cout << "\n";
+
+		CacheCpp::SeqlockHashCache<int, std::string> seqlock(capacity, 8);
+		RunConcurrentTest("Seqlock-Hash", seqlock, threads, operations, writePercent);
+	}
+
+	void CacheTestRunner::RunReadScaling(int capacity, int maxThreads, int operations) {
+		std::cout << "=== Read scaling [capacity=" << capacity << ", ops/thread=" << operations
+			<< ", reads only, all hits] ===\n";
+
+		auto measure = [&](CacheCpp::ICachePolicy<int, std::string>& cache, int threads) {
+			Timer timer;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; ++t) {
+				workers.emplace_back([&, t] {
+					std::mt19937 gen(t + 1);
+					std::string val;
+					for (int op = 0; op < operations; ++op)
+						cache.Get(static_cast<int>(gen() % capacity), val);
+				});
+			}
+			for (auto& worker : workers)
+				worker.join();
+			return double(threads) * operations / timer.elapsedMs() / 1000.0;
+		};
+
+		CacheCpp::LRUHashCache<int, std::string> sharded(capacity, 8);
+		CacheCpp::SeqlockHashCache<int, std::string> seqlock(capacity, 8);
+		for (int key = 0; key < capacity; ++key) {
+			sharded.Put(key, "val" + std::to_string(key));
+			seqlock.Put(key, "val" + std::to_string(key));
+		}
+
+		for (int threads = 1; threads <= maxThreads; threads *= 2) {
+			std::cout << std::setw(8) << threads << " threads | "
+				<< "LRU-Hash: " << std::setw(8) << std::fixed << std::setprecision(2) << measure(sharded, threads)
+				<< " Mops/s | Seqlock-Hash: " << std::setw(8) << measure(seqlock, threads) << " Mops/s\n";
+		}
+	}
+
+	void CacheTestRunner::RunNegativeLookups(int capacity, int threads, int operations, int missPercent) {
+		std::cout << "=== Negative lookups [capacity=" << capacity << ", threads=" << threads
+			<< ", ops/thread=" << operations << ", absent keys=" << missPercent << "%] ===\n";
+
+		// the cache is filled once; absent keys come from a disjoint range and are never inserted
+		auto drive = [&](const std::string& name, CacheCpp::ICachePolicy<int, std::string>& cache) {
+			for (int key = 0; key < capacity; ++key)
+				cache.Put(key, "val" + std::to_string(key));
+
+			std::atomic<int> hit{ 0 };
+			Timer timer;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; ++t) {
+				workers.emplace_back([&, t] {
+					std::mt19937 gen(t + 1);
+					int local_hit = 0;
+					std::string val;
+					for (int op = 0; op < operations; ++op) {
+						int key = static_cast<int>(gen() % 100) < missPercent
+							? capacity + static_cast<int>(gen() % (capacity * 100))
+							: static_cast<int>(gen() % capacity);
+						if (cache.Get(key, val))
+							local_hit++;
+					}
+					hit += local_hit;
+				});
+			}
+			for (auto& worker : workers)
+				worker.join();
+
+			double elapsed = timer.elapsedMs();
+			double total_ops = double(threads) * operations;
+			std::cout << std::setw(14) << name << " | "
+				<< "Hit rate: " << std::setw(6) << std::fixed << std::setprecision(2)
+				<< (100.0 * hit / total_ops) << "% | "
+				<< "Throughput: " << std::setw(8) << std::fixed << std::setprecision(2)
+				<< (total_ops / elapsed / 1000.0) << " Mops/s";
+		};
+
+		CacheCpp::LRUHashCache<int, std::string> plain(capacity, 8);
+		drive("LRU-Hash", plain);
+		std::cout << "\n";
+
+		CacheCpp::LRUHashOptions filter_options;
+		filter_options.filterCountersPerKey = 8;
+		CacheCpp::LRUHashCache<int, std::string> filtered(capacity, 8, filter_options);
+		drive("LRU-Hash+Bloom", filtered);
+		CacheCpp::NegativeFilterStats stats = filtered.FilterStats();
+		std::cout << " | Lock acquisitions saved: " << stats.rejected
+			<< ", false positives: " << stats.falsePositives
+			<< " (" << std::setprecision(2) << 100.0 * stats.FalsePositiveRate() << "%)\n";
+	}
+
+	void CacheTestRunner::RunConcurrentTest(const std::string& name,
+		CacheCpp::ICachePolicy<int, std::string>& cache,
+		int threads,
+		int operations,
+		int writePercent) {
+		std::atomic<int> hit{ 0 };
+		Timer timer;
+
+		std::vector<std::thread> workers;
+		for (int t = 0; t < threads; ++t) {
+			workers.emplace_back([&, t] {
+				std::mt19937 gen(t + 1);
+				int local_hit = 0;
+				std::string val;
+				for (int op = 0; op < operations; ++op) {
+					int key = NextKey(AccessPattern::Hotspot, op, gen);
+					if (static_cast<int>(gen() % 100) < writePercent) {
+						cache.Put(key, "val" + std::to_string(key));
+					}
+					else if (cache.Get(key, val)) {
+						local_hit++;
+					}
+					else {
+						cache.Put(key, "val" + std::to_string(key));
+					}
+				}
+				hit += local_hit;
+			});
+		}
+		for (auto& worker : workers)
+			worker.join();
+
+		double elapsed = timer.elapsedMs();
+		double total_ops = double(threads) * operations;
+		std::cout << std::setw(12) << name << " | "
+			<< "Hit rate: " << std::setw(6) << std::fixed << std::setprecision(2)
+			<< (100.0 * hit / total_ops) << "% | "
+			<< "Throughput: " << std::setw(8) << std::fixed << std::setprecision(2)
+			<< (total_ops / elapsed / 1000.0) << " Mops/s\n";
+	}
+
+	void CacheTestRunner::RunSharedMemory(int capacity, int processes, int operations) {
+#if CACHECPP_HAS_SHARED_MEMORY
+		std::cout << "=== Shared-memory cache [capacity=" << capacity << ", processes=" << processes
+			<< ", ops/process=" << operations << "] ===\n";
+
+		// values carry their own key so every process can check what it reads back
+		struct Payload {
+			int key;
+			int writer;
+			char bytes[56];
+		};
+		using SharedCache = CacheCpp::SharedMemoryCache<int, Payload>;
+
+		const std::string name = "/cachecpp_bench_" + std::to_string(getpid());
+		SharedCache::Unlink(name);
+		SharedCache owner(name, capacity, 8);
+
+		// per-child counters, in their own anonymous shared mapping
+		struct ChildStats {
+			int hits;
+			int gets;
+			int corrupt;
+		};
+		void* stats_mem = mmap(nullptr, sizeof(ChildStats) * processes, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		ChildStats* stats = static_cast<ChildStats*>(stats_mem);
+
+		Timer timer;
+		std::vector<pid_t> children;
+		for (int p = 0; p < processes; ++p) {
+			pid_t pid = fork();
+			if (pid == 0) {
+				// attach independently, as an unrelated worker process would
+				SharedCache cache(name, capacity, 8);
+				std::mt19937 gen(p + 1);
+				ChildStats local{ 0, 0, 0 };
+				for (int op = 0; op < operations; ++op) {
+					int key = NextKey(AccessPattern::Hotspot, op, gen);
+					Payload payload;
+					local.gets++;
+					if (cache.Get(key, payload)) {
+						local.hits++;
+						if (payload.key != key) local.corrupt++;
+					}
+					else {
+						payload.key = key;
+						payload.writer = p;
+						std::memset(payload.bytes, 'a' + p, sizeof(payload.bytes));
+						cache.Put(key, payload);
+					}
+				}
+				stats[p] = local;
+				_exit(0);
+			}
+			children.push_back(pid);
+		}
+
+		int failed = 0;
+		for (pid_t pid : children) {
+			int status = 0;
+			waitpid(pid, &status, 0);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+		}
+		double elapsed = timer.elapsedMs();
+
+		long hits = 0, gets = 0, corrupt = 0;
+		for (int p = 0; p < processes; ++p) {
+			hits += stats[p].hits;
+			gets += stats[p].gets;
+			corrupt += stats[p].corrupt;
+		}
+		munmap(stats_mem, sizeof(ChildStats) * processes);
+
+		std::cout << std::setw(10) << "SHM-LRU" << " | "
+			<< "Hit rate: " << std::setw(6) << std::fixed << std::setprecision(2)
+			<< (100.0 * hits / gets) << "% | "
+			<< "Time: " << std::setw(8) << elapsed << "ms | "
+			<< "Entries: " << owner.Size() << " | Segment: " << owner.SegmentSize() / 1024 << " KiB | "
+			<< "Corrupt reads: " << corrupt << " | Failed processes: " << failed << "\n";
+
+		SharedCache::Unlink(name);
+#endif
+	}
+
+	void CacheTestRunner::RunTiered(int capacity, int workingSet, int operations) {
+		std::cout << "=== Memory + disk tier [capacity=" << capacity << ", working set=" << workingSet
+			<< ", ops=" << operations << ", read-through] ===\n";
+
+		auto drive = [&](const std::string& name, CacheCpp::ICachePolicy<int, std::string>& cache) {
+			std::mt19937 gen(11);
+			int hit = 0;
+			Timer timer;
+			for (int op = 0; op < operations; ++op) {
+				int key = gen() % workingSet;
+				std::string val;
+				if (cache.Get(key, val)) hit++;
+				else cache.Put(key, "val" + std::to_string(key) + std::string(200, 'x'));
+			}
+			double elapsed = timer.elapsedMs();
+			std::cout << std::setw(10) << name << " | "
+				<< "Hit rate: " << std::setw(6) << std::fixed << std::setprecision(2)
+				<< (100.0 * hit / operations) << "% | "
+				<< "Time: " << std::setw(8) << elapsed << "ms";
+		};
+
+		CacheCpp::LRUCache<int, std::string> memory_only(capacity);
+		drive("LRU", memory_only);
+		std::cout << "\n";
+
+		const std::filesystem::path directory =
+			std::filesystem::temp_directory_path() / ("cachecpp_tier_" + std::to_string(std::random_device{}()));
+		{
+			CacheCpp::TieredCache<int, std::string> tiered(
+				std::make_unique<CacheCpp::LRUCache<int, std::string>>(capacity), directory.string(), 64 * 1024 * 1024);
+			drive("LRU+Disk", tiered);
+			tiered.Flush();
+			std::cout << " | Memory hits: " << tiered.MemoryHits() << ", disk hits: " << tiered.DiskHits()
+				<< ", on disk: " << tiered.DiskEntries() << " entries / " << tiered.DiskBytes() / 1024 << " KiB\n";
+		}
+		std::filesystem::remove_all(directory);
+	}
+
+	int CacheTestRunner::NextKey(AccessPattern pattern, int op, std::mt19937& gen) {
+		const int HOT_KEYS = 20;
+		const int COLD_KEYS = 5000;
+		const int SCAN_WINDOW = 1000;
+		const int SCAN_LENGTH = 300;
+
+		switch (pattern) {
+		case AccessPattern::Hotspot:
+			return (op % 100 < 70) ? gen() % HOT_KEYS : HOT_KEYS + (gen() % COLD_KEYS);
+		case AccessPattern::Scan:
+			// every window starts with a run of never-repeated keys, then falls back to the hotspot mix
+			if (op % SCAN_WINDOW < SCAN_LENGTH)
+				return HOT_KEYS + COLD_KEYS + op;
+			return (op % 100 < 70) ? gen() % HOT_KEYS : HOT_KEYS + (gen() % COLD_KEYS);
+		default:
+			return gen() % (HOT_KEYS + COLD_KEYS);
+		}
 	}
 
 	void CacheTestRunner::RunSingleTest(const std::string& name,
@@ -75,9 +711,6 @@ namespace Test {
 		int capacity,
 		int operations,
 		AccessPattern pattern) {
-		const int HOT_KEYS = 20;
-		const int COLD_KEYS = 5000;
-
 		std::random_device rd;
 		std::mt19937 gen(rd());
 
@@ -86,30 +719,19 @@ namespace Test {
 
 		// Insert phase
 		for (int op = 0; op < operations; ++op) {
-			int key;
-			if (pattern == AccessPattern::Hotspot) {
-				key = (op % 100 < 70) ? gen() % HOT_KEYS : HOT_KEYS + (gen() % COLD_KEYS);
-			}
-			else {
-				key = gen() % (HOT_KEYS + COLD_KEYS);
-			}
-
+			int key = NextKey(pattern, op, gen);
 			cache->Put(key, "val" + std::to_string(key));
 		}
 
 		// Access phase
 		for (int op = 0; op < operations; ++op) {
-			int key;
-			if (pattern == AccessPattern::Hotspot) {
-				key = (op % 100 < 70) ? gen() % HOT_KEYS : HOT_KEYS + (gen() % COLD_KEYS);
-			}
-			else {
-				key = gen() % (HOT_KEYS + COLD_KEYS);
-			}
+			int key = NextKey(pattern, op, gen);
 
 			std::string val;
 			get_ops++;
 			if (cache->Get(key, val)) hit++;
+			// scans only hurt when misses are filled back in, as a read-through cache would
+			else if (pattern == AccessPattern::Scan) cache->Put(key, "val" + std::to_string(key));
 		}
 
 		double elapsed = timer.elapsedMs();
@@ -130,6 +752,18 @@ int main() {
 
 	Test::CacheTestRunner::Run(capacity, operations, AccessPattern::Hotspot);
 	Test::CacheTestRunner::Run(capacity, operations, AccessPattern::Random);
+	Test::CacheTestRunner::Run(capacity, operations, AccessPattern::Scan);
+
+	Test::CacheTestRunner::RunAllocations(capacity, 10000);
+	Test::CacheTestRunner::RunMissCost(500, operations);
+	Test::CacheTestRunner::RunPhaseShift(1000, 100000, 6);
+	Test::CacheTestRunner::RunSlabStore(10000, 200000);
+	Test::CacheTestRunner::RunSlabResidency(10000, 200000, 10);
+	Test::CacheTestRunner::RunTiered(1000, 10000, 200000);
+	Test::CacheTestRunner::RunSharedMemory(1000, 4, 200000);
+	Test::CacheTestRunner::RunConcurrent(1000, std::max(2u, std::thread::hardware_concurrency()), 200000, 1);
+	Test::CacheTestRunner::RunReadScaling(1000, std::max(2u, std::thread::hardware_concurrency()), 200000);
+	Test::CacheTestRunner::RunNegativeLookups(1000, std::max(2u, std::thread::hardware_concurrency()), 200000, 40);
 
 	return 0;
 }
\ No newline at end of file